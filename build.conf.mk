@@ -5,6 +5,7 @@
 # DATA is a list of directories containing data files
 # INCLUDES is a list of directories containing header files
 # ROMFS is the directory containing data to be added to RomFS, relative to the Makefile (Optional)
+# IMAGES is a list of directories containing .jpg files to be decoded at build time and linked in
 #
 # NO_ICON: if set to anything, do not use icon.
 # NO_NACP: if set to anything, no .nacp file is generated.
@@ -38,6 +39,7 @@ SOURCES     :=	src
 # nanovg
 SOURCES		+=	src/nanovg src/nanovg/deko3d src/nanovg/deko3d/framework src/nanovg/deko3d/shaders
 DATA		:=	data
+IMAGES		:=	assets/images
 ROMFS		:=	assets/romfs
 
 # Output folders for autogenerated files in romfs
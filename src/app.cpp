@@ -1,10 +1,25 @@
 #include "app.hpp"
 #include "nvg_util.hpp"
 #include "nanovg/deko3d/nanovg_dk.h"
+#include "init_graph.hpp"
+#include "play_cache.hpp"
+#include "string_format.hpp"
+#include "parallel.hpp"
+
+// generated by the Makefile from assets/images
+extern "C" {
+#include "default_icon_bin.h"
+}
 
 #include <algorithm>
 #include <ranges>
 #include <cassert>
+#include <span>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
 
 #ifndef NDEBUG
     #include <cstdio>
@@ -40,6 +55,50 @@ struct PulseColour {
 
 PulseColour pulse;
 
+auto get_nickname(AccountUid uid) -> std::string {
+    AccountProfile profile;
+    AccountUserData user_data;
+    AccountProfileBase profile_base{};
+
+    if (R_FAILED(accountGetProfile(&profile, uid))) {
+        return "Unknown";
+    }
+
+    const auto result = accountProfileGet(&profile, &user_data, &profile_base);
+    accountProfileClose(&profile);
+    if (R_FAILED(result)) {
+        return "Unknown";
+    }
+
+    return std::string{profile_base.nickname, strnlen(profile_base.nickname, sizeof(profile_base.nickname))};
+}
+
+// on screen keyboard for the search, one character per key.
+constexpr std::size_t KEYBOARD_COLUMNS = 10;
+constexpr std::string_view KEYBOARD_KEYS{
+    "1234567890"
+    "qwertyuiop"
+    "asdfghjkl'"
+    "zxcvbnm-:."
+    "!?&+/(),# "
+};
+
+// hours and minutes, to keep the columns narrow.
+auto format_hours(u64 seconds) -> std::string {
+    return string_format("%lu:%02lu", seconds / 3600, seconds / 60 % 60);
+}
+
+// yyyy-mm-dd from days since the unix epoch.
+auto format_day(std::uint32_t day) -> std::string {
+    if (!day) {
+        return "never";
+    }
+
+    using namespace std::chrono;
+    const year_month_day date{sys_days{days{day}}};
+    return string_format("%d-%02u-%02u", static_cast<int>(date.year()), static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+}
+
 void update_pulse_colour() {
     if (pulse.col.g == 255) {
         pulse.increase_blue = true;
@@ -61,6 +120,7 @@ void update_pulse_colour() {
 void App::Loop() {
     while (!this->quit && appletMainLoop()) {
         this->Poll();
+        this->dispatcher.run_pending();
         this->Update();
         this->Draw();
     }
@@ -93,6 +153,8 @@ void App::Poll() {
 }
 
 void App::Update() {
+    this->MergeScanned();
+
     switch (this->menu_mode) {
         case MenuMode::LOAD:
             this->UpdateLoad();
@@ -100,6 +162,21 @@ void App::Update() {
         case MenuMode::LIST:
             this->UpdateList();
             break;
+        case MenuMode::HEATMAP:
+            this->UpdateHeatmap();
+            break;
+        case MenuMode::USERS:
+            this->UpdateUsers();
+            break;
+        case MenuMode::SEARCH:
+            this->UpdateSearch();
+            break;
+        case MenuMode::STATS:
+            this->UpdateStats();
+            break;
+        case MenuMode::AUTHORS:
+            this->UpdateAuthors();
+            break;
     }
 }
 
@@ -118,6 +195,21 @@ void App::Draw() {
         case MenuMode::LIST:
             this->DrawList();
             break;
+        case MenuMode::HEATMAP:
+            this->DrawHeatmap();
+            break;
+        case MenuMode::USERS:
+            this->DrawUsers();
+            break;
+        case MenuMode::SEARCH:
+            this->DrawSearch();
+            break;
+        case MenuMode::STATS:
+            this->DrawStats();
+            break;
+        case MenuMode::AUTHORS:
+            this->DrawAuthors();
+            break;
     }
 
     nvgEndFrame(this->vg);
@@ -131,8 +223,35 @@ void App::DrawBackground() {
 }
 
 void App::DrawLoad() {
+    constexpr auto bar_w = 600.f;
+    constexpr auto bar_h = 12.f;
+    constexpr auto bar_x = (SCREEN_WIDTH - bar_w) / 2.f;
+    constexpr auto bar_y = SCREEN_HEIGHT / 2.f + 40.f;
+    const auto& p = this->progress;
+
     gfx::drawRect(this->vg, 0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT, gfx::Colour::BLACK);
     gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f, 36.f, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE, gfx::Colour::WHITE, "Loading...");
+
+    if (!p.total) {
+        gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, bar_y, 22.f, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::SILVER,
+                "Listing applications (%lu)", p.records_listed);
+    } else {
+        gfx::drawRect(this->vg, bar_x, bar_y, bar_w, bar_h, gfx::Colour::DARK_GREY);
+        gfx::drawRect(this->vg, bar_x, bar_y, bar_w * p.fraction, bar_h, gfx::Colour::CYAN);
+
+        gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, bar_y + 30.f, 22.f, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::WHITE,
+                "%lu / %lu", p.titles_done, p.total);
+
+        if (p.eta_seconds >= 0.0) {
+            gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, bar_y + 60.f, 22.f, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::SILVER,
+                    "%.1f titles/s - ETA %.0fs", p.titles_per_second, p.eta_seconds);
+        }
+
+        gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, bar_y + 90.f, 20.f, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::SILVER,
+                "control data %lu - stats %lu - icons %lu - failed %lu",
+                p.control_data_fetched, p.stats_queried, p.icons_decoded, p.failures);
+    }
+
     gfx::drawButtons(this->vg, gfx::pair{gfx::Button::B, "Back"});
 }
 
@@ -164,7 +283,10 @@ void App::DrawList() {
 
     auto y = this->yoff;
 
-    for (size_t i = this->start; i < this->entries.size(); i++) {
+    const auto& order = this->Order();
+    for (size_t i = this->start; i < order.size(); i++) {
+        const auto row = order[i];
+        const auto name = this->titles.Name(row);
         if (i == this->index) {
             // idk how to draw an outline, so i draw a colour rect then draw black rect ontop
             auto col = pulse.col;
@@ -180,12 +302,12 @@ void App::DrawList() {
         gfx::drawRect(this->vg, x, y, box_width, 1.f, gfx::Colour::DARK_GREY);
         gfx::drawRect(this->vg, x, y + box_height, box_width, 1.f, gfx::Colour::DARK_GREY);
 
-        const auto icon_paint = nvgImagePattern(this->vg, x + icon_spacing, y + icon_spacing, 90.f, 90.f, 0.f, this->entries[i].image, 1.f);
+        const auto icon_paint = nvgImagePattern(this->vg, x + icon_spacing, y + icon_spacing, 90.f, 90.f, 0.f, this->titles.Image(row), 1.f);
         gfx::drawRect(this->vg, x + icon_spacing, y + icon_spacing, 90.f, 90.f, icon_paint);
 
         nvgSave(this->vg);
         nvgScissor(this->vg, x + title_spacing_left, y, 585.f, box_height); // clip
-        gfx::drawText(this->vg, x + title_spacing_left, y + title_spacing_top, 24.f, this->entries[i].name.c_str(), nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE);
+        gfx::drawText(this->vg, x + title_spacing_left, y + title_spacing_top, 24.f, name.data(), name.data() + name.size(), NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE);
         nvgRestore(this->vg);
 
         const auto draw_playtime = [&](float x_offset, Playtime playtime) {
@@ -193,7 +315,11 @@ void App::DrawList() {
                     "Playtime: %s", playtime.toString().c_str());
         };
 
-        draw_playtime(0.f, this->entries[i].playtime);
+        draw_playtime(0.f, Playtime::fromSeconds(this->titles.Seconds(row)));
+
+        if (!this->titles.Installed(row)) {
+            gfx::drawText(this->vg, x + box_width - 20.f, y + text_spacing_top + 9.f, 22.f, "Not installed", nullptr, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP, gfx::Colour::GREY);
+        }
 
         y += box_height;
 
@@ -205,27 +331,435 @@ void App::DrawList() {
 
     nvgRestore(this->vg);
 
-    AppEntry current_entry = this->entries[this->index];
-    gfx::drawTextArgs(this->vg, 55.f, 670.f, 24.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE, 
-            "Current (%lu / %lu): %s", 
-                this->index + 1, this->entries.size(), 
-                current_entry.playtime.toString().c_str());
+    // up in the header, the buttons take the whole bottom bar.
+    auto current_playtime = Playtime::fromSeconds(this->titles.Seconds(this->Order()[this->index]));
+    gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, 22.f, 22.f, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::WHITE,
+            "Current (%lu / %lu): %s",
+                this->index + 1, this->Order().size(),
+                current_playtime.toString().c_str());
+
+    if (!this->filter_error.empty()) {
+        gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, 52.f, 18.f, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::RED,
+                "%s - Filter: %s", this->GetSortStr(), this->filter_error.c_str());
+    } else if (this->filter) {
+        const auto text = this->filter->Text();
+        gfx::drawTextArgs(this->vg, SCREEN_WIDTH / 2.f, 52.f, 18.f, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::SILVER,
+                "%s - Filter: %.*s", this->GetSortStr(), static_cast<int>(text.size()), text.data());
+    } else {
+        gfx::drawText(this->vg, SCREEN_WIDTH / 2.f, 52.f, 18.f, this->GetSortStr(), nullptr, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::SILVER);
+    }
 
     gfx::drawButtons(this->vg, 
             gfx::pair{gfx::Button::B, "Exit"}, 
-            gfx::pair{gfx::Button::R, this->GetSortStr()});
+            gfx::pair{gfx::Button::R, "Sort"},
+            gfx::pair{gfx::Button::X, "Calendar"},
+            gfx::pair{gfx::Button::Y, "Users"},
+            gfx::pair{gfx::Button::MINUS, this->show_uninstalled ? "Hide uninstalled" : "Show uninstalled"},
+            gfx::pair{gfx::Button::PLUS, "Search"},
+            gfx::pair{gfx::Button::L, "Filter"},
+            gfx::pair{gfx::Button::ZL, "Stats"});
+
+}
+
+void App::DrawHeatmap() {
+    constexpr auto cell = 20.f;
+    constexpr auto x = (SCREEN_WIDTH - Heatmap::WEEKS * cell) / 2.f;
+    constexpr auto y = 220.f;
+    constexpr const char* weekdays[] = {"Mon", "Wed", "Fri"};
+
+    const auto row = this->Order()[this->index];
+    const auto id = this->heatmap_all ? Heatmap::ALL_TITLES : this->titles.Id(row);
+    const auto name = this->heatmap_all ? std::string_view{"All titles"} : this->titles.Name(row);
+    this->heatmap.Update(this->vg, this->history, id, this->heatmap_year);
+
+    gfx::drawTextArgs(this->vg, 70.f, 40.f, 28.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE, "%.*s - %d",
+            static_cast<int>(name.size()), name.data(), this->heatmap_year);
+
+    for (int i = 0; i < 3; i++) {
+        gfx::drawText(this->vg, x - 10.f, y + (i * 2 + 0.5f) * cell, 18.f, weekdays[i], nullptr, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE, gfx::Colour::SILVER);
+    }
+
+    this->heatmap.Draw(this->vg, x, y, cell);
+
+    auto total = Playtime::fromSeconds(this->heatmap.TotalSeconds());
+    auto best = Playtime::fromSeconds(this->heatmap.BestDaySeconds());
+    gfx::drawTextArgs(this->vg, x, y + Heatmap::WEEKDAYS * cell + 40.f, 24.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE,
+            "Total: %s", total.toString().c_str());
+    gfx::drawTextArgs(this->vg, x, y + Heatmap::WEEKDAYS * cell + 75.f, 22.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::SILVER,
+            "Days played: %d - Best day: %s", this->heatmap.DaysPlayed(), best.toString().c_str());
 
+    gfx::drawButtons(this->vg,
+            gfx::pair{gfx::Button::B, "Back"},
+            gfx::pair{gfx::Button::R, "Next year"},
+            gfx::pair{gfx::Button::L, "Prev year"},
+            gfx::pair{gfx::Button::Y, this->heatmap_all ? "Selected title" : "All titles"});
 }
 
+void App::DrawUsers() {
+    constexpr auto x = 70.f;
+    constexpr auto name_w = 430.f;
+    constexpr auto row_h = 40.f;
+    constexpr std::size_t visible_rows = 11;
+    const auto& m = this->user_matrix;
+
+    gfx::drawText(this->vg, 70.f, 40.f, 28.f, "Users", nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE);
+
+    if (m.Empty()) {
+        gfx::drawText(this->vg, SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f, 36.f, this->users_thread.is_ready() ? "No users" : "Loading...", nullptr,
+                NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE, gfx::Colour::WHITE);
+        gfx::drawButtons(this->vg, gfx::pair{gfx::Button::B, "Back"});
+        return;
+    }
+
+    const auto col_w = (SCREEN_WIDTH - 2 * x - name_w) / m.ColumnCount();
+    const auto col_x = [&](std::size_t column) { return x + name_w + (column + 1) * col_w - 10.f; };
+    const auto col_colour = [&](std::size_t column) {
+        return column == this->user_matrix_column ? gfx::Colour::CYAN : gfx::Colour::SILVER;
+    };
+
+    // header, the combined column comes last
+    for (std::size_t column = 0; column < m.ColumnCount(); column++) {
+        const auto name = column == m.CombinedColumn() ? "All" : m.Users()[column].nickname.c_str();
+        nvgSave(this->vg);
+        nvgScissor(this->vg, col_x(column) - col_w + 10.f, 95.f, col_w - 5.f, row_h);
+        gfx::drawText(this->vg, col_x(column), 100.f, 20.f, name, nullptr, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP, col_colour(column));
+        nvgRestore(this->vg);
+    }
+
+    auto y = 135.f;
+    const auto end = std::min(this->user_matrix_start + visible_rows, this->user_matrix_order.size());
+    for (auto i = this->user_matrix_start; i < end; i++) {
+        const auto title = this->user_matrix_order[i];
+        if (i == this->user_matrix_index) {
+            gfx::drawRect(this->vg, x - 10.f, y, SCREEN_WIDTH - 2 * x + 20.f, row_h, gfx::Colour::LIGHT_BLACK);
+        }
+
+        nvgSave(this->vg);
+        nvgScissor(this->vg, x, y, name_w - 10.f, row_h);
+        gfx::drawText(this->vg, x, y + row_h / 2.f, 20.f, this->user_matrix_names[title].c_str(), nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE, gfx::Colour::WHITE);
+        nvgRestore(this->vg);
+
+        for (std::size_t column = 0; column < m.ColumnCount(); column++) {
+            gfx::drawText(this->vg, col_x(column), y + row_h / 2.f, 20.f, format_hours(m.Get(title, column)).c_str(), nullptr,
+                    NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE, col_colour(column));
+        }
+
+        y += row_h;
+    }
+
+    gfx::drawText(this->vg, x, 670.f, 22.f, "Total", nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE);
+    for (std::size_t column = 0; column < m.ColumnCount(); column++) {
+        gfx::drawText(this->vg, col_x(column), 655.f, 20.f, format_hours(m.ColumnTotal(column)).c_str(), nullptr,
+                NVG_ALIGN_RIGHT | NVG_ALIGN_TOP, col_colour(column));
+    }
+
+    gfx::drawButtons(this->vg,
+            gfx::pair{gfx::Button::B, "Back"},
+            gfx::pair{gfx::Button::R, "Next user"},
+            gfx::pair{gfx::Button::L, "Prev user"});
+}
+
+void App::DrawSearch() {
+    constexpr auto x = 90.f;
+    constexpr auto row_h = 36.f;
+    constexpr std::size_t visible_rows = 7;
+    constexpr auto key_w = 56.f;
+    constexpr auto key_h = 42.f;
+    constexpr auto key_gap = 6.f;
+    constexpr auto keyboard_x = (SCREEN_WIDTH - KEYBOARD_COLUMNS * (key_w + key_gap)) / 2.f;
+    constexpr auto keyboard_y = 400.f;
+
+    gfx::drawTextArgs(this->vg, 70.f, 40.f, 28.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE, "Search: %s_", this->search_query.c_str());
+
+    if (!this->search_thread.is_ready()) {
+        gfx::drawText(this->vg, x, 100.f, 22.f, "Indexing...", nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::SILVER);
+    } else if (this->search_query.empty()) {
+        gfx::drawText(this->vg, x, 100.f, 22.f, "Type a name or author", nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::SILVER);
+    } else {
+        gfx::drawTextArgs(this->vg, 1190.f, 100.f, 20.f, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP, gfx::Colour::SILVER, "%zu results in %.2f ms",
+                this->search_results.size(), static_cast<double>(this->search_time) / 1e6);
+    }
+
+    auto y = 130.f;
+    const auto end = std::min(this->search_start + visible_rows, this->search_results.size());
+    for (auto i = this->search_start; i < end; i++) {
+        const auto row = this->search_results[i];
+        const auto name = this->titles.Name(row);
+        const auto author = this->titles.Author(row);
+        if (i == this->search_selected) {
+            gfx::drawRect(this->vg, x - 10.f, y, SCREEN_WIDTH - 2 * x + 20.f, row_h, gfx::Colour::LIGHT_BLACK);
+        }
+
+        nvgSave(this->vg);
+        nvgScissor(this->vg, x, y, 700.f, row_h);
+        gfx::drawText(this->vg, x, y + row_h / 2.f, 22.f, name.data(), name.data() + name.size(), NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE, gfx::Colour::WHITE);
+        nvgRestore(this->vg);
+
+        nvgSave(this->vg);
+        nvgScissor(this->vg, x + 720.f, y, SCREEN_WIDTH - 2 * x - 720.f, row_h);
+        gfx::drawText(this->vg, SCREEN_WIDTH - x, y + row_h / 2.f, 20.f, author.data(), author.data() + author.size(), NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE, gfx::Colour::SILVER);
+        nvgRestore(this->vg);
+
+        y += row_h;
+    }
+
+    for (std::size_t key = 0; key < KEYBOARD_KEYS.size(); key++) {
+        const auto key_x = keyboard_x + (key % KEYBOARD_COLUMNS) * (key_w + key_gap);
+        const auto key_y = keyboard_y + (key / KEYBOARD_COLUMNS) * (key_h + key_gap);
+        const auto selected = key == this->search_key;
+        gfx::drawRect(this->vg, key_x, key_y, key_w, key_h, selected ? gfx::Colour::CYAN : gfx::Colour::LIGHT_BLACK);
+
+        const auto c = KEYBOARD_KEYS[key];
+        const auto label = c == ' ' ? std::string_view{"Space"} : KEYBOARD_KEYS.substr(key, 1);
+        gfx::drawText(this->vg, key_x + key_w / 2.f, key_y + key_h / 2.f, c == ' ' ? 16.f : 24.f, label.data(), label.data() + label.size(),
+                NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE, selected ? gfx::Colour::BLACK : gfx::Colour::WHITE);
+    }
+
+    gfx::drawButtons(this->vg,
+            gfx::pair{gfx::Button::B, this->search_query.empty() ? "Back" : "Delete"},
+            gfx::pair{gfx::Button::A, "Type"},
+            gfx::pair{gfx::Button::X, "Clear"},
+            gfx::pair{gfx::Button::ZR, "Next result"},
+            gfx::pair{gfx::Button::PLUS, "Go to title"});
+}
+
+void App::DrawStats() {
+    constexpr auto x = 90.f;
+    constexpr auto top_x = 560.f;
+    constexpr auto row_h = 34.f;
+    constexpr auto bar_y = 560.f;
+    constexpr auto bar_max_h = 120.f;
+    const auto& stats = *this->stats;
+
+    gfx::drawText(this->vg, 70.f, 40.f, 28.f, "Statistics", nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE);
+
+    const std::pair<const char*, u64> lines[] = {
+        {"Total", stats.total},
+        {"Mean", stats.mean},
+        {"Median", stats.median},
+        {"90th percentile", stats.p90},
+    };
+
+    auto y = 110.f;
+    gfx::drawTextArgs(this->vg, x, y, 22.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE, "Titles: %zu (%zu played)", stats.count, stats.played);
+    for (const auto& [label, seconds] : lines) {
+        y += row_h;
+        auto playtime = Playtime::fromSeconds(seconds);
+        gfx::drawTextArgs(this->vg, x, y, 22.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::SILVER, "%s: %s", label, playtime.toString().c_str());
+    }
+
+    gfx::drawText(this->vg, top_x, 110.f, 22.f, "Most played", nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE);
+    y = 110.f;
+    for (std::size_t i = 0; i < stats.top.size(); i++) {
+        y += row_h;
+        const auto row = stats.top[i];
+        const auto name = this->titles.Name(row);
+        nvgSave(this->vg);
+        nvgScissor(this->vg, top_x, y, 500.f, row_h);
+        gfx::drawTextArgs(this->vg, top_x, y, 20.f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::SILVER, "%zu. %.*s", i + 1, static_cast<int>(name.size()), name.data());
+        nvgRestore(this->vg);
+        gfx::drawText(this->vg, SCREEN_WIDTH - x, y, 20.f, format_hours(this->titles.Seconds(row)).c_str(), nullptr, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP, gfx::Colour::SILVER);
+    }
+
+    // histogram, bars scaled to the biggest bucket
+    constexpr auto buckets = PlaytimeStats::BUCKET_HOURS.size();
+    constexpr auto bar_w = 50.f;
+    constexpr auto bar_gap = 8.f;
+    const auto biggest = std::max(1u, *std::ranges::max_element(stats.histogram));
+    for (std::size_t i = 0; i < buckets; i++) {
+        const auto bar_x = x + i * (bar_w + bar_gap);
+        const auto h = bar_max_h * stats.histogram[i] / biggest;
+        gfx::drawRect(this->vg, bar_x, bar_y - h, bar_w, h, gfx::Colour::CYAN);
+        gfx::drawTextArgs(this->vg, bar_x + bar_w / 2.f, bar_y - h - 4.f, 16.f, NVG_ALIGN_CENTER | NVG_ALIGN_BOTTOM, gfx::Colour::WHITE, "%u", stats.histogram[i]);
+
+        const auto hours = PlaytimeStats::BUCKET_HOURS[i];
+        const auto label = i + 1 < buckets ? string_format("%luh", hours) : string_format("%luh+", hours);
+        gfx::drawText(this->vg, bar_x + bar_w / 2.f, bar_y + 6.f, 16.f, label.c_str(), nullptr, NVG_ALIGN_CENTER | NVG_ALIGN_TOP, gfx::Colour::SILVER);
+    }
+
+    gfx::drawButtons(this->vg,
+            gfx::pair{gfx::Button::B, "Back"},
+            gfx::pair{gfx::Button::Y, "Authors"});
+}
+
+void App::DrawAuthors() {
+    constexpr auto x = 70.f;
+    constexpr auto row_h = 40.f;
+    constexpr std::size_t visible_lines = 12;
+    const auto& groups = *this->author_groups;
+
+    gfx::drawText(this->vg, 70.f, 40.f, 28.f, "Authors", nullptr, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, gfx::Colour::WHITE);
+    gfx::drawTextArgs(this->vg, SCREEN_WIDTH - x, 45.f, 22.f, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP, gfx::Colour::SILVER, "%zu authors", groups.Groups().size());
+
+    // only the lines on screen are looked up, however many titles are expanded.
+    auto y = 110.f;
+    const auto end = std::min(this->author_start + visible_lines, groups.LineCount());
+    for (auto line = this->author_start; line < end; line++) {
+        const auto [group, title] = groups.LineAt(line);
+        const auto& g = groups.Groups()[group];
+        if (line == this->author_line) {
+            gfx::drawRect(this->vg, x - 10.f, y, SCREEN_WIDTH - 2 * x + 20.f, row_h, gfx::Colour::LIGHT_BLACK);
+        }
+
+        if (title == AuthorGroups::HEADER) {
+            const auto author = this->titles.AuthorById(g.author);
+            const auto name = author.empty() ? std::string_view{"Unknown"} : author;
+            nvgSave(this->vg);
+            nvgScissor(this->vg, x, y, 560.f, row_h);
+            gfx::drawTextArgs(this->vg, x, y + row_h / 2.f, 22.f, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE, gfx::Colour::WHITE, "%c %.*s",
+                    groups.Expanded(group) ? '-' : '+', static_cast<int>(name.size()), name.data());
+            nvgRestore(this->vg);
+            gfx::drawTextArgs(this->vg, SCREEN_WIDTH - x, y + row_h / 2.f, 20.f, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE, gfx::Colour::SILVER,
+                    "%u titles - %s - last played %s", g.count, format_hours(g.seconds).c_str(), format_day(g.last_played).c_str());
+        } else {
+            const auto row = groups.Titles(group)[title];
+            const auto name = this->titles.Name(row);
+            nvgSave(this->vg);
+            nvgScissor(this->vg, x + 30.f, y, 800.f, row_h);
+            gfx::drawText(this->vg, x + 30.f, y + row_h / 2.f, 20.f, name.data(), name.data() + name.size(), NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE, gfx::Colour::SILVER);
+            nvgRestore(this->vg);
+            gfx::drawText(this->vg, SCREEN_WIDTH - x, y + row_h / 2.f, 20.f, format_hours(this->titles.Seconds(row)).c_str(), nullptr,
+                    NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE, gfx::Colour::SILVER);
+        }
+
+        y += row_h;
+    }
+
+    gfx::drawButtons(this->vg,
+            gfx::pair{gfx::Button::B, "Back"},
+            gfx::pair{gfx::Button::A, "Expand / Collapse"},
+            gfx::pair{gfx::Button::R, "Next author"},
+            gfx::pair{gfx::Button::L, "Prev author"});
+}
+
+auto App::BuildOrder(const TitleTable& titles, SortType type, bool show_uninstalled, std::span<const std::uint8_t> filter_mask) -> SortedOrder {
+    // big libraries are split over the pool, small ones stay on this thread.
+    auto& pool = util::ThreadPool::get_default();
+    SortedOrder sorted;
+    auto& rows = sorted.rows;
+
+    // filter first, so only the rows that are shown get sorted.
+    const auto flags = titles.FlagsColumn();
+    rows = util::parallel_filter<TitleTable::Row>(pool, titles.Size(), [flags, show_uninstalled, filter_mask](auto row) {
+        return (show_uninstalled || (flags[row] & TitleTable::Flag_Installed)) && (filter_mask.empty() || filter_mask[row]);
+    });
+
+    switch (type)
+    {
+        case SortType::Alpha_AZ: util::parallel_sort(pool, std::span{rows}, [&titles](auto a, auto b) { return titles.NameLess(a, b); }); break;
+        case SortType::Alpha_ZA: util::parallel_sort(pool, std::span{rows}, [&titles](auto a, auto b) { return titles.NameLess(b, a); }); break;
+        case SortType::Playtime_BigSmall: SortByPlaytime(titles, rows, true); break;
+        case SortType::Playtime_SmallBig: SortByPlaytime(titles, rows, false); break;
+        case SortType::MAX: break;
+    }
+
+    sorted.positions.assign(titles.Size(), SortedOrder::NOT_SHOWN);
+    for (std::uint32_t i = 0; i < rows.size(); i++) {
+        sorted.positions[rows[i]] = i;
+    }
+
+    return sorted;
+}
+
+const std::vector<TitleTable::Row>& App::Order() const {
+    static const std::vector<TitleTable::Row> empty{};
+    const auto& sorted = this->sort_cache[this->sort_type];
+    return sorted ? sorted->rows : empty;
+}
+
+// rebuilds the current order from scratch, when the titles or filter change.
 void App::Sort()
 {
-    switch (static_cast<SortType>(this->sort_type))
-    {
-        case SortType::Alpha_AZ: std::ranges::sort(this->entries, [](AppEntry& a, AppEntry& b) { return a.name < b.name; }); break;
-        case SortType::Alpha_ZA: std::ranges::sort(this->entries, [](AppEntry& a, AppEntry& b) { return a.name > b.name; }); break;
-        case SortType::Playtime_BigSmall: std::ranges::sort(this->entries, [](AppEntry& a, AppEntry& b) { return a.playtime.totalSeconds() > b.playtime.totalSeconds(); }); break;
-        case SortType::Playtime_SmallBig: std::ranges::sort(this->entries, [](AppEntry& a, AppEntry& b) { return a.playtime.totalSeconds() < b.playtime.totalSeconds(); }); break;
+    const auto selected = this->Order().empty() ? std::nullopt : std::optional{this->Order()[this->index]};
+    const auto type = static_cast<SortType>(this->sort_type);
+
+    this->sort_generation++;
+    for (auto& sorted : this->sort_cache) {
+        sorted.reset();
+    }
+
+    this->sort_cache[this->sort_type] = BuildOrder(this->titles, type, this->show_uninstalled, this->filter_mask);
+    this->SelectRow(selected.value_or(SortedOrder::NOT_SHOWN));
+}
+
+void App::ChangeSort(SortType type) {
+    auto& sorted = this->sort_cache[std::to_underlying(type)];
+    if (sorted) {
+        this->ApplySort(type);
+        return;
+    }
+
+    if (this->titles.Size() < BACKGROUND_SORT_MIN) {
+        sorted = BuildOrder(this->titles, type, this->show_uninstalled, this->filter_mask);
+        this->ApplySort(type);
+        return;
+    }
+
+    // one at a time, the list keeps the old order until it's done.
+    if (this->sort_thread.valid() && !this->sort_thread.is_ready()) {
+        return;
+    }
+
+    // the table isn't touched once the scan is done, so it can be read from the pool.
+    // the mask is copied as the filter may change while sorting.
+    this->sort_thread = util::async([&titles = this->titles, type, show_uninstalled = this->show_uninstalled, filter_mask = this->filter_mask]{
+        return BuildOrder(titles, type, show_uninstalled, filter_mask);
+    }).then(this->dispatcher, [this, type, generation = this->sort_generation](SortedOrder sorted){
+        // the filter changed while sorting.
+        if (generation != this->sort_generation) {
+            return;
+        }
+
+        this->sort_cache[std::to_underlying(type)] = std::move(sorted);
+        this->ApplySort(type);
+    });
+}
+
+// switches to an already built order, keeping the selected title selected.
+void App::ApplySort(SortType type) {
+    const auto selected = this->Order().empty() ? SortedOrder::NOT_SHOWN : this->Order()[this->index];
+    this->sort_type = std::to_underlying(type);
+    this->SelectRow(selected);
+
+    // a sort from the pool can finish while searching.
+    if (this->menu_mode == MenuMode::SEARCH) {
+        this->RunSearch();
+    }
+}
+
+void App::SelectRow(TitleTable::Row row) {
+    const auto& positions = this->sort_cache[this->sort_type]->positions;
+    const auto position = row < positions.size() ? positions[row] : SortedOrder::NOT_SHOWN;
+
+    // shown at the top of the list, or start from the top if it's gone.
+    this->index = position == SortedOrder::NOT_SHOWN ? 0 : position;
+    this->start = this->index;
+    this->ypos = 130.f;
+    this->yoff = 130.f;
+}
+
+// reran on every key typed, so only the titles sharing the query's
+// trigrams are checked. best matches come first, then list order.
+void App::RunSearch() {
+    const util::instrument::Stopwatch stopwatch;
+    this->search_results.clear();
+    this->search_selected = 0;
+    this->search_start = 0;
+
+    auto matches = this->search_index.Find(this->titles, this->search_query);
+    const auto& positions = this->sort_cache[this->sort_type]->positions;
+    // hidden titles can't be jumped to.
+    std::erase_if(matches, [&positions](const auto& match) { return positions[match.row] == SortedOrder::NOT_SHOWN; });
+    std::ranges::sort(matches, [&positions](const auto& a, const auto& b) {
+        return std::pair{a.rank, positions[a.row]} < std::pair{b.rank, positions[b.row]};
+    });
+
+    this->search_results.reserve(matches.size());
+    for (const auto& match : matches) {
+        this->search_results.emplace_back(match.row);
     }
+
+    this->search_time = stopwatch.elapsed();
 }
 
 const char* App::GetSortStr() {
@@ -240,28 +774,24 @@ const char* App::GetSortStr() {
 }
 
 void App::UpdateLoad() {
+    this->UpdateProgress();
+
+    // switching to the list is done by the scan continuation.
     if (this->controller.B) {
         this->async_thread.request_stop();
-        this->async_thread.get();
         this->quit = true;
-        return;
     }
+}
 
-    {
-        std::scoped_lock lock{this->mutex};
-        if (this->finished_scanning) {
-            this->async_thread.get();
-            this->Sort();
-            this->menu_mode = MenuMode::LIST;
-        }
-    }
+void App::UpdateProgress() {
+    this->progress = this->scan_progress.Sample();
 }
 
 void App::UpdateList() {
     if (this->controller.B) {
         this->quit = true;
     } else if (this->controller.DOWN) { // move down
-        if (this->index < (this->entries.size() - 1)) {
+        if (this->index < (this->Order().size() - 1)) {
             this->index++;
             this->ypos += this->BOX_HEIGHT;
             if ((this->ypos + this->BOX_HEIGHT) > 646.f) {
@@ -271,7 +801,7 @@ void App::UpdateList() {
             }
         }
     } else if (this->controller.UP) { // move up
-        if (this->index != 0 && this->entries.size()) {
+        if (this->index != 0 && this->Order().size()) {
             this->index--;
             this->ypos -= this->BOX_HEIGHT;
             if (this->ypos < 86.f) {
@@ -281,122 +811,711 @@ void App::UpdateList() {
             }
         }
     } else if (this->controller.R) {
-        this->sort_type++;
+        const auto next = (this->sort_type + 1) % std::to_underlying(SortType::MAX);
+        this->ChangeSort(static_cast<SortType>(next));
+    } else if (this->controller.SELECT) {
+        this->ToggleUninstalled();
+    } else if (this->controller.Y) {
+        if (!this->users_thread.valid()) {
+            this->SpawnUsersScan();
+        }
+        this->menu_mode = MenuMode::USERS;
+    } else if (this->controller.L) {
+        this->EditFilter();
+    } else if (this->controller.L2) {
+        // only recomputed once the listed titles change.
+        if (!this->stats || this->stats_generation != this->sort_generation) {
+            this->stats = PlaytimeStats::Compute(this->titles, this->Order());
+            this->stats_generation = this->sort_generation;
+        }
+        this->menu_mode = MenuMode::STATS;
+    } else if (this->controller.START) {
+        this->search_query.clear();
+        this->RunSearch();
+        this->menu_mode = MenuMode::SEARCH;
+    } else if (this->controller.X && !this->Order().empty()) {
+        using namespace std::chrono;
+        const year_month_day today{sys_days{days{LocalToday(LocalUtcOffset())}}};
+        this->heatmap_year = static_cast<int>(today.year());
+        this->menu_mode = MenuMode::HEATMAP;
+    }
+}
 
-        if (this->sort_type == std::to_underlying(SortType::MAX)) {
-            this->sort_type = 0;
+void App::ToggleUninstalled() {
+    // nothing would be left to show.
+    if (!this->AnyShown(!this->show_uninstalled, this->filter_mask)) {
+        return;
+    }
+
+    this->show_uninstalled ^= true;
+    this->Sort();
+}
+
+bool App::AnyShown(bool show_uninstalled, std::span<const std::uint8_t> filter_mask) const {
+    const auto flags = this->titles.FlagsColumn();
+    for (TitleTable::Row row = 0; row < flags.size(); row++) {
+        if ((show_uninstalled || (flags[row] & TitleTable::Flag_Installed)) && (filter_mask.empty() || filter_mask[row])) {
+            return true;
         }
+    }
+    return false;
+}
+
+// the query is typed on the system keyboard, as it needs symbols the
+// search keyboard doesn't have.
+void App::EditFilter() {
+    SwkbdConfig config;
+    if (const auto result = swkbdCreate(&config, 0); R_FAILED(result)) {
+        LOG("Failed to create keyboard. Result: %d\n", result);
+        return;
+    }
 
+    const std::string initial{this->filter ? this->filter->Text() : std::string_view{}};
+    std::array<char, 256> text{};
+    swkbdConfigMakePresetDefault(&config);
+    swkbdConfigSetHeaderText(&config, "Filter");
+    swkbdConfigSetGuideText(&config, "playtime > 10h and author = \"Nintendo\"");
+    swkbdConfigSetInitialText(&config, initial.c_str());
+    swkbdConfigSetStringLenMax(&config, text.size() - 1);
+    const auto result = swkbdShow(&config, text.data(), text.size());
+    swkbdClose(&config);
+
+    // cancelled
+    if (R_FAILED(result)) {
+        return;
+    }
+
+    this->SetFilter(text.data());
+}
+
+// an empty text removes the filter, a filter that fails to compile or
+// matches nothing leaves the current one in place.
+void App::SetFilter(std::string_view text) {
+    this->filter_error.clear();
+
+    if (text.empty()) {
+        this->filter.reset();
+        this->filter_mask.clear();
         this->Sort();
-    } 
+        return;
+    }
+
+    auto query = FilterQuery::Compile(text, this->filter_error);
+    if (!query) {
+        return;
+    }
+
+    const auto today = LocalToday(LocalUtcOffset());
+    auto mask = query->Evaluate({this->titles, this->last_played, today});
+    if (!this->AnyShown(this->show_uninstalled, mask)) {
+        this->filter_error = "Nothing matches";
+        return;
+    }
+
+    this->filter = std::move(query);
+    this->filter_mask = std::move(mask);
+    this->Sort();
+}
+
+void App::UpdateUsers() {
+    constexpr std::size_t visible_rows = 11;
+    const auto count = this->user_matrix_order.size();
+
+    if (this->controller.B) {
+        this->menu_mode = MenuMode::LIST;
+    } else if (this->user_matrix.Empty()) {
+        return;
+    } else if (this->controller.DOWN) {
+        if (this->user_matrix_index + 1 < count) {
+            this->user_matrix_index++;
+        }
+    } else if (this->controller.UP) {
+        if (this->user_matrix_index) {
+            this->user_matrix_index--;
+        }
+    } else if (this->controller.R || this->controller.L) {
+        const auto columns = this->user_matrix.ColumnCount();
+        this->user_matrix_column = (this->user_matrix_column + (this->controller.R ? 1 : columns - 1)) % columns;
+        this->user_matrix_order = this->user_matrix.SortedBy(this->user_matrix_column);
+        this->user_matrix_index = 0;
+    }
+
+    // keep the selection on screen
+    if (this->user_matrix_index < this->user_matrix_start) {
+        this->user_matrix_start = this->user_matrix_index;
+    } else if (this->user_matrix_index >= this->user_matrix_start + visible_rows) {
+        this->user_matrix_start = this->user_matrix_index - visible_rows + 1;
+    }
+}
+
+void App::UpdateSearch() {
+    constexpr std::size_t visible_rows = 7;
+    constexpr auto rows = KEYBOARD_KEYS.size() / KEYBOARD_COLUMNS;
+    auto column = this->search_key % KEYBOARD_COLUMNS;
+    auto row = this->search_key / KEYBOARD_COLUMNS;
+
+    if (this->controller.B) {
+        if (this->search_query.empty()) {
+            this->menu_mode = MenuMode::LIST;
+            return;
+        }
+        // the keyboard only types ascii, so this is always a whole character.
+        this->search_query.pop_back();
+        this->RunSearch();
+    } else if (this->controller.A) {
+        this->search_query += KEYBOARD_KEYS[this->search_key];
+        this->RunSearch();
+    } else if (this->controller.X) {
+        this->search_query.clear();
+        this->RunSearch();
+    } else if (this->controller.LEFT) {
+        column = (column + KEYBOARD_COLUMNS - 1) % KEYBOARD_COLUMNS;
+    } else if (this->controller.RIGHT) {
+        column = (column + 1) % KEYBOARD_COLUMNS;
+    } else if (this->controller.UP) {
+        row = (row + rows - 1) % rows;
+    } else if (this->controller.DOWN) {
+        row = (row + 1) % rows;
+    } else if (this->controller.R2) {
+        if (this->search_selected + 1 < this->search_results.size()) {
+            this->search_selected++;
+        }
+    } else if (this->controller.L2) {
+        if (this->search_selected) {
+            this->search_selected--;
+        }
+    } else if (this->controller.START && !this->search_results.empty()) {
+        this->SelectRow(this->search_results[this->search_selected]);
+        this->menu_mode = MenuMode::LIST;
+        return;
+    }
+
+    this->search_key = row * KEYBOARD_COLUMNS + column;
+
+    // keep the selection on screen
+    if (this->search_selected < this->search_start) {
+        this->search_start = this->search_selected;
+    } else if (this->search_selected >= this->search_start + visible_rows) {
+        this->search_start = this->search_selected - visible_rows + 1;
+    }
+}
+
+void App::UpdateStats() {
+    if (this->controller.B) {
+        this->menu_mode = MenuMode::LIST;
+    } else if (this->controller.Y) {
+        // like the stats, only regrouped once the listed titles change.
+        if (!this->author_groups || this->author_groups_generation != this->sort_generation) {
+            this->author_groups = AuthorGroups::Build(this->titles, this->Order(), this->last_played);
+            this->author_groups_generation = this->sort_generation;
+            this->author_line = 0;
+            this->author_start = 0;
+        }
+        this->menu_mode = MenuMode::AUTHORS;
+    }
+}
+
+void App::UpdateAuthors() {
+    constexpr std::size_t visible_lines = 12;
+    auto& groups = *this->author_groups;
+
+    if (this->controller.B) {
+        this->menu_mode = MenuMode::STATS;
+        return;
+    } else if (groups.Empty()) {
+        return;
+    } else if (this->controller.DOWN) {
+        if (this->author_line + 1 < groups.LineCount()) {
+            this->author_line++;
+        }
+    } else if (this->controller.UP) {
+        if (this->author_line) {
+            this->author_line--;
+        }
+    } else if (this->controller.A) {
+        // collapsing from one of its titles moves back up to the header.
+        const auto group = groups.LineAt(this->author_line).group;
+        groups.Toggle(group);
+        this->author_line = groups.HeaderLine(group);
+    } else if (this->controller.R) {
+        const auto group = groups.LineAt(this->author_line).group;
+        if (group + 1 < groups.Groups().size()) {
+            this->author_line = groups.HeaderLine(group + 1);
+        }
+    } else if (this->controller.L) {
+        const auto [group, title] = groups.LineAt(this->author_line);
+        if (title != AuthorGroups::HEADER) {
+            this->author_line = groups.HeaderLine(group);
+        } else if (group) {
+            this->author_line = groups.HeaderLine(group - 1);
+        }
+    }
+
+    // keep the selection on screen
+    if (this->author_line < this->author_start) {
+        this->author_start = this->author_line;
+    } else if (this->author_line >= this->author_start + visible_lines) {
+        this->author_start = this->author_line - visible_lines + 1;
+    }
+}
+
+void App::UpdateHeatmap() {
+    if (this->controller.B) {
+        this->menu_mode = MenuMode::LIST;
+    } else if (this->controller.Y) {
+        this->heatmap_all ^= true;
+    } else if (this->controller.L) {
+        this->heatmap_year--;
+    } else if (this->controller.R) {
+        this->heatmap_year++;
+    }
 }
 
 #define SECONDS_PER_HOUR 3600
 #define NANOSECONDS_PER_SECOND 1000000000
 #define SECONDS_PER_MINUTE 60
 
-// NOTE: there's a chance that we run out of memory here
-// if the user has a *lot* of games installed.
-void App::Scan(std::stop_token stop_token) {
-    Result result{};
-    s32 offset{};
-    u64 jpeg_size{};
-    size_t count{};
-    NacpLanguageEntry* language_entry{};
-    auto control_data = std::make_unique<NsApplicationControlData>();
+util::Task<std::vector<NsApplicationRecord>> App::ListRecords() {
+    const auto stop_token = co_await util::get_stop_token();
+    std::vector<NsApplicationRecord> records;
     std::array<NsApplicationRecord, 30> record_list;
-    ApplicationOccupiedSize size{};
-    PdmPlayStatistics pdm_play_statistics[1] = {0};
+    s32 offset{};
 
-    for (;;) {
+    while (!stop_token.stop_requested()) {
         s32 record_count{};
-        result = nsListApplicationRecord(record_list.data(), static_cast<s32>(record_list.size()), offset, &record_count);
+        const auto result = nsListApplicationRecord(record_list.data(), static_cast<s32>(record_list.size()), offset, &record_count);
         if (R_FAILED(result)) {
             LOG("failed to get record count\n");
-            goto done;
+            break;
         }
 
         // either we have ran out of games or we have no games installed.
         if (record_count == 0) {
             LOG("record count is 0\n");
-            goto done;
+            break;
+        }
+
+        records.insert(records.end(), record_list.begin(), record_list.begin() + record_count);
+        this->scan_progress.records_listed.add(record_count);
+
+        // if we have less than count, then we are done!
+        if (static_cast<size_t>(record_count) < record_list.size()) {
+            break;
         }
 
-        for (auto i = 0; i < record_count && !stop_token.stop_requested(); i++) {
+        offset += record_count;
+    }
+
+    this->scan_progress.total.store(records.size());
+    co_return records;
+}
+
+util::Task<int> App::DecodeIcon(NsApplicationControlData& control_data, u64 jpeg_size) {
+    assert((jpeg_size - sizeof(NacpStruct)) > 0 && "jpeg size is smaller than the size of NacpStruct");
+    const auto image = nvgCreateImageMem(this->vg, 0, control_data.icon, jpeg_size - sizeof(NacpStruct));
+    this->scan_progress.icons_decoded.add();
+    co_return image;
+}
+
+// everything here is the same for every user, so it runs while the user
+// selector is still open.
+util::Task<AppEntry> App::LoadMetadata(AppID application_id, NsApplicationControlData& control_data) {
 #ifndef NDEBUG
-            LOG("Current application: %lX\n", record_list[i].application_id);
+    LOG("Current application: %lX\n", application_id);
 #endif
 
-            bool corrupted_install = false;
-            AppEntry entry;
-            result = nsGetApplicationControlData(NsApplicationControlSource_Storage, record_list[i].application_id, control_data.get(), sizeof(NsApplicationControlData), &jpeg_size);
-            // can fail with very messed up piracy installs, it would fail in ofw as well.
-            if (R_FAILED(result)) {
-                LOG("failed to get control data for %lX\n", record_list[i].application_id);
-                corrupted_install = true;
+    Result result{};
+    u64 jpeg_size{};
+    NacpLanguageEntry* language_entry{};
+    bool corrupted_install = false;
+    AppEntry entry;
+    entry.id = application_id;
+
+    result = nsGetApplicationControlData(NsApplicationControlSource_Storage, application_id, &control_data, sizeof(NsApplicationControlData), &jpeg_size);
+    // can fail with very messed up piracy installs, it would fail in ofw as well.
+    if (R_FAILED(result)) {
+        LOG("failed to get control data for %lX\n", application_id);
+        corrupted_install = true;
+    } else {
+        this->scan_progress.control_data_fetched.add();
+    }
+
+    result = nsGetApplicationDesiredLanguage(&control_data.nacp, &language_entry);
+    if (R_FAILED(result)) {
+        LOG("failed to get lang data\n");
+        corrupted_install = true;
+    }
+
+    if (!corrupted_install) {
+        entry.name = language_entry->name;
+        entry.author = language_entry->author;
+        entry.display_version = control_data.nacp.display_version;
+        entry.image = co_await this->DecodeIcon(control_data, jpeg_size);
+        entry.own_image = true; // we own it
+
+        // keep it around in case the title gets deleted later on.
+        this->metadata_cache.Store(application_id, entry.name, entry.author, entry.display_version,
+                std::span{control_data.icon, jpeg_size - sizeof(NacpStruct)});
+    } else {
+        this->MarkCorrupted(entry);
+    }
+
+    co_return entry;
+}
+
+bool App::QueryPlaytime(AppEntry& entry, AccountUid uid) {
+    const auto seconds = this->QueryPlaytimeSeconds(entry.id, uid);
+    if (!seconds) {
+        return false;
+    }
+
+    entry.playtime = Playtime::fromSeconds(*seconds);
+    return true;
+}
+
+std::optional<u64> App::QueryPlaytimeSeconds(AppID application_id, AccountUid uid) {
+    PdmPlayStatistics pdm_play_statistics[1] = {0};
+
+    // get play statistics of application
+    const auto result = pdmqryQueryPlayStatisticsByApplicationIdAndUserAccountId(application_id, uid, false, pdm_play_statistics);
+    if (R_FAILED(result)) {
+        LOG("Failed getting time of application. Result: %d\n", result);
+        return std::nullopt;
+    }
+
+    this->scan_progress.stats_queried.add();
+    return pdm_play_statistics->playtime / NANOSECONDS_PER_SECOND;
+}
+
+std::optional<PlaytimeEngine> App::LoadPlayEvents(AccountUid uid, std::stop_token stop_token) {
+    const auto utc_offset = LocalUtcOffset();
+    PlaytimeEngine engine{uid, utc_offset};
+    PlayCursor cursor{};
+    const PlayCache cache{uid};
+
+    // carry on from where the last launch stopped, unless the log was
+    // rotated / reset since, in which case everything is folded again.
+    if (!cache.Load(engine, cursor) || !IsCursorValid(cursor)) {
+        engine = PlaytimeEngine{uid, utc_offset};
+        cursor = {};
+        // older events have been rotated out, the totals would come up short.
+        if (!IsCursorValid(cursor)) {
+            LOG("Play event log was rotated, querying per title\n");
+            return std::nullopt;
+        }
+    }
+
+    const auto start_index = cursor.next_index;
+    if (const auto result = FoldPlayEvents(engine, cursor, stop_token); R_FAILED(result)) {
+        LOG("Failed reading play events. Result: %d\n", result);
+        return std::nullopt;
+    }
+
+    if (stop_token.stop_requested()) {
+        return std::nullopt;
+    }
+
+    LOG("Folded %d new play events\n", cursor.next_index - start_index);
+    if (cursor.next_index != start_index && !cache.Save(engine, cursor)) {
+        LOG("Failed saving %s\n", cache.Path().c_str());
+    }
+
+    this->scan_progress.events_read.store(cursor.next_index - start_index);
+    return engine;
+}
+
+void App::MarkCorrupted(AppEntry& entry) {
+    if (entry.own_image) {
+        nvgDeleteImage(this->vg, entry.image);
+    }
+
+    entry.name = "Corrupted";
+    entry.author = "Corrupted";
+    entry.display_version = "Corrupted";
+    entry.image = this->default_icon_image;
+    entry.own_image = false; // we don't own it
+    entry.playtime = Playtime(0, 0, 0);
+    this->has_corrupted = true;
+    this->scan_progress.failures.add();
+}
+
+AppEntry App::LoadUninstalled(AppID application_id, u64 playtime_seconds) {
+    AppEntry entry;
+    entry.id = application_id;
+    entry.installed = false;
+    entry.playtime = Playtime::fromSeconds(playtime_seconds);
+    entry.image = this->default_icon_image;
+
+    if (const auto cached = this->metadata_cache.Find(application_id)) {
+        entry.name = this->metadata_cache.Text(cached->name);
+        entry.author = this->metadata_cache.Text(cached->author);
+        entry.display_version = this->metadata_cache.Text(cached->display_version);
+    } else {
+        // never seen installed while we were around to cache it.
+        entry.name = string_format("%016lX", application_id);
+        entry.author = "Unknown";
+        entry.display_version = "Unknown";
+    }
+
+    std::vector<std::uint8_t> icon;
+    if (this->metadata_cache.LoadIcon(application_id, icon)) {
+        if (const auto image = nvgCreateImageMem(this->vg, 0, icon.data(), icon.size())) {
+            entry.image = image;
+            entry.own_image = true;
+            this->scan_progress.icons_decoded.add();
+        }
+    }
+
+    return entry;
+}
+
+// NOTE: there's a chance that we run out of memory here
+// if the user has a *lot* of games installed.
+util::Task<void> App::Scan(util::AsyncFuture<AccountUid> account) {
+    const auto stop_token = co_await util::get_stop_token();
+    auto control_data = std::make_unique<NsApplicationControlData>();
+    std::vector<AppEntry> metadata;
+    this->scan_progress.Start();
+
+    const auto free_images = [this](std::span<AppEntry> list) {
+        for (auto& entry : list) {
+            if (entry.own_image) {
+                nvgDeleteImage(this->vg, entry.image);
             }
+        }
+    };
 
-            result = nsGetApplicationDesiredLanguage(&control_data->nacp, &language_entry);
-            if (R_FAILED(result)) {
-                LOG("failed to get lang data\n");
-                corrupted_install = true;
+    // phase 1: user independent, overlaps with the user selector.
+    this->metadata_cache.Load();
+    const auto records = co_await this->ListRecords();
+    metadata.reserve(records.size());
+
+    for (const auto& record : records) {
+        if (stop_token.stop_requested()) {
+            free_images(metadata);
+            co_return;
+        }
+
+        metadata.emplace_back(co_await this->LoadMetadata(record.application_id, *control_data));
+        this->scan_progress.metadata_done.add();
+        // let other queued work run in between titles.
+        co_await util::yield();
+    }
+
+    this->scan_progress.EndMetadata();
+    if (!this->metadata_cache.Save()) {
+        LOG("Failed saving metadata cache\n");
+    }
+
+    // phase 2: play statistics of the selected user.
+    const auto uid = co_await std::move(account);
+    this->scan_progress.StartStats();
+    // one pass over the event log covers every title at once.
+    const auto play_events = this->LoadPlayEvents(uid, stop_token);
+
+    // titles that were played but aren't installed anymore.
+    if (play_events) {
+        std::unordered_map<AppID, std::size_t> installed;
+        installed.reserve(metadata.size());
+        for (std::size_t i = 0; i < metadata.size(); i++) {
+            installed.emplace(metadata[i].id, i);
+        }
+
+        const auto installed_count = metadata.size();
+        for (const auto& [id, seconds] : play_events->Totals()) {
+            if (seconds && !installed.contains(id)) {
+                metadata.emplace_back(this->LoadUninstalled(id, seconds));
+            }
+        }
+
+        const auto uninstalled_count = metadata.size() - installed_count;
+        this->scan_progress.total.add(uninstalled_count);
+        this->scan_progress.metadata_done.add(uninstalled_count);
+    }
+
+    for (std::size_t i = 0; i < metadata.size(); i++) {
+        auto& entry = metadata[i];
+        if (stop_token.stop_requested()) {
+            free_images(std::span{metadata}.subspan(i));
+            co_return;
+        }
+
+        // corrupted entries have no stats to query.
+        if (entry.installed && entry.own_image) {
+            if (play_events) {
+                entry.playtime = Playtime::fromSeconds(play_events->Seconds(entry.id));
+                this->scan_progress.stats_queried.add();
+            } else if (!this->QueryPlaytime(entry, uid)) {
+                this->MarkCorrupted(entry);
             }
+        }
 
-            // get play statistics of application
-            result = pdmqryQueryPlayStatisticsByApplicationIdAndUserAccountId(record_list[i].application_id, this->account_uid, false, pdm_play_statistics);
-            if (R_FAILED(result)) {
-                LOG("Failed getting time of application. Result: %d\n", result);
-                corrupted_install = true;
+        // the ui drains the queue once per frame, so sleep until it has if
+        // it's full. nothing drains once stopped, so stopping wakes it too.
+        while (!this->scanned_entries.try_push(std::move(entry))) {
+            if (stop_token.stop_requested()) {
+                free_images(std::span{metadata}.subspan(i));
+                co_return;
             }
 
-            if (!corrupted_install) {
-                u64 playtimeSeconds = pdm_play_statistics->playtime / NANOSECONDS_PER_SECOND;
-                u64 playtimeHours = playtimeSeconds / SECONDS_PER_HOUR;
-                playtimeSeconds -= playtimeHours * SECONDS_PER_HOUR;
-                u64 playtimeMinutes = playtimeSeconds / SECONDS_PER_MINUTE;
-                playtimeSeconds -= playtimeMinutes * SECONDS_PER_MINUTE;
-
-                entry.name = language_entry->name;
-                entry.author = language_entry->author;
-                entry.display_version = control_data->nacp.display_version;
-                entry.id = record_list[i].application_id;
-                assert((jpeg_size - sizeof(NacpStruct)) > 0 && "jpeg size is smaller than the size of NacpStruct");
-                entry.image = nvgCreateImageMem(this->vg, 0, control_data->icon, jpeg_size - sizeof(NacpStruct));
-                entry.own_image = true; // we own it
-                entry.playtime = Playtime(playtimeHours, playtimeMinutes, playtimeSeconds);
-                this->entries.emplace_back(std::move(entry));
-                count++;
-            } else {
-                entry.name = "Corrupted";
-                entry.author = "Corrupted";
-                entry.display_version = "Corrupted";
-                entry.id = record_list[i].application_id;
-                entry.image = this->default_icon_image;
-                entry.own_image = false; // we don't own it
-                entry.playtime = Playtime(0, 0, 0);
-                this->entries.emplace_back(std::move(entry));
-                this->has_corrupted = true;
-                count++;
+            auto space = this->WaitScannedSpace();
+            const std::stop_callback on_stop{stop_token, [this]{ this->SignalScannedSpace(); }};
+            // the ui may have drained before there was anything to fire.
+            const auto pushed = this->scanned_entries.try_push(std::move(entry));
+            if (pushed) {
+                this->SignalScannedSpace();
+            }
+            co_await std::move(space);
+            if (pushed) {
+                break;
             }
         }
+        this->scan_progress.titles_done.add();
+    }
 
-        // if we have less than count, then we are done!
-        if (static_cast<size_t>(record_count) < record_list.size()) {
-            goto done;
+    // the ui only looks at it once the scan is done.
+    if (play_events) {
+        this->history = play_events->History();
+    }
+
+    util::instrument::Registry::get().log();
+}
+
+void App::MergeScanned() {
+    const auto merged = this->scanned_entries.drain([this](AppEntry&& entry){
+        this->titles.Add(std::move(entry));
+    });
+
+    if (merged) {
+        this->SignalScannedSpace();
+    }
+}
+
+util::AsyncFuture<void> App::WaitScannedSpace() {
+    std::scoped_lock lock{this->scanned_space_mutex};
+    return this->scanned_space.emplace().get_future();
+}
+
+// fires the promise at most once, both the ui and a stop request may get here.
+void App::SignalScannedSpace() {
+    std::optional<util::AsyncPromise<void>> space;
+    {
+        std::scoped_lock lock{this->scanned_space_mutex};
+        space.swap(this->scanned_space);
+    }
+
+    if (space) {
+        space->set_value();
+    }
+}
+
+// the user independent metadata is already in the list, so only the
+// play statistics have to be fetched for each user.
+util::Task<UserMatrix> App::ScanUsers(std::vector<AppID> titles) {
+    const auto stop_token = co_await util::get_stop_token();
+    AccountUid uids[ACC_USER_LIST_SIZE]{};
+    s32 count{};
+
+    if (const auto result = accountListAllUsers(uids, ACC_USER_LIST_SIZE, &count); R_FAILED(result)) {
+        LOG("Failed listing users. Result: %d\n", result);
+        co_return UserMatrix{};
+    }
+
+    std::vector<UserMatrix::User> users;
+    for (s32 i = 0; i < count; i++) {
+        users.emplace_back(uids[i], get_nickname(uids[i]));
+    }
+
+    UserMatrix matrix{std::move(users), std::move(titles)};
+    for (std::size_t user = 0; user < matrix.UserCount(); user++) {
+        if (stop_token.stop_requested()) {
+            co_return UserMatrix{};
         }
 
-        offset += record_count;
+        const auto uid = matrix.Users()[user].uid;
+        const auto play_events = this->LoadPlayEvents(uid, stop_token);
+        for (std::size_t title = 0; title < matrix.Titles().size(); title++) {
+            const auto id = matrix.Titles()[title];
+            const auto seconds = play_events ? play_events->Seconds(id) : this->QueryPlaytimeSeconds(id, uid).value_or(0);
+            matrix.Set(title, user, seconds);
+        }
+
+        co_await util::yield();
+    }
+
+    matrix.Finish();
+    co_return matrix;
+}
+
+void App::SpawnUsersScan() {
+    const auto ids = this->titles.Ids();
+    std::vector<AppID> titles{ids.begin(), ids.end()};
+    std::unordered_map<AppID, std::string> names;
+    names.reserve(ids.size());
+    for (TitleTable::Row row = 0; row < this->titles.Size(); row++) {
+        names.emplace(this->titles.Id(row), this->titles.Name(row));
     }
 
-done:
-    std::scoped_lock lock{this->mutex};
-    this->finished_scanning = true;
+    this->users_thread = util::spawn(util::ThreadPool::get_default(), this->ScanUsers(std::move(titles))
+    ).then(this->dispatcher, [this, names = std::move(names)](std::stop_token stop_token, UserMatrix matrix) mutable {
+            if (stop_token.stop_requested()) {
+                return;
+            }
+
+            this->user_matrix_names.clear();
+            for (const auto id : matrix.Titles()) {
+                this->user_matrix_names.emplace_back(std::move(names[id]));
+            }
+
+            this->user_matrix = std::move(matrix);
+            this->user_matrix_column = this->user_matrix.CombinedColumn();
+            this->user_matrix_order = this->user_matrix.SortedBy(this->user_matrix_column);
+            this->user_matrix_index = 0;
+            this->user_matrix_start = 0;
+        }
+    );
+}
+
+// built on the pool as the table isn't touched once the scan is done,
+// searching finds nothing until it's ready.
+void App::SpawnSearchIndex() {
+    this->search_thread = util::async([&titles = this->titles]{
+        SearchIndex index;
+        index.Build(titles);
+        return index;
+    }).then(this->dispatcher, [this](SearchIndex index){
+        this->search_index = std::move(index);
+        if (this->menu_mode == MenuMode::SEARCH) {
+            this->RunSearch();
+        }
+    });
 }
 
 void App::SpawnScanThread() {
     // todo: handle errors
-    this->async_thread = util::async([this](std::stop_token stop_token){
-            this->Scan(stop_token);
+    this->async_thread = util::spawn(util::ThreadPool::get_default(), this->Scan(this->account_promise.get_future())
+    ).then(this->dispatcher, [this](std::stop_token stop_token){
+            if (!stop_token.stop_requested()) {
+                this->MergeScanned();
+                this->Sort();
+                this->SpawnSearchIndex();
+
+                // for filtering on when a title was last played.
+                this->last_played.assign(this->titles.Size(), 0);
+                for (TitleTable::Row row = 0; row < this->titles.Size(); row++) {
+                    if (const auto title = this->history.Find(this->titles.Id(row)); title >= 0) {
+                        const auto days = this->history.Days(title);
+                        this->last_played[row] = days.empty() ? 0 : days.back();
+                    }
+                }
+                this->menu_mode = MenuMode::LIST;
+
+#ifndef NDEBUG
+                const auto& strings = this->titles.Strings();
+                LOG("Title text: %zu bytes for %lu requested, %lu saved by interning\n",
+                    strings.stored_bytes(), strings.requested_bytes(), strings.requested_bytes() - strings.stored_bytes());
+#endif
+            }
         }
     );
 }
@@ -415,65 +1534,119 @@ void App::RequestAccountUid() {
 #ifndef NDEBUG
     LOG("Selected user.\n");
 #endif
+
+    this->account_promise.set_value(this->account_uid);
 }
 
 App::App() {
+    using Where = InitGraph::Where;
+    InitGraph graph;
     PlFontData font_standard, font_extended;
-    plGetSharedFontByType(&font_standard, PlSharedFontType_Standard);
-    plGetSharedFontByType(&font_extended, PlSharedFontType_NintendoExt);
-
-    // Create the deko3d device
-    this->device = dk::DeviceMaker{}.create();
-
-    // Create the main queue
-    this->queue = dk::QueueMaker{this->device}.setFlags(DkQueueFlags_Graphics).create();
-
-    // Create the memory pools
-    this->pool_images.emplace(device, DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 16*1024*1024);
-    this->pool_code.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Code, 128*1024);
-    this->pool_data.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 1*1024*1024);
-
-    // Create the static command buffer and feed it freshly allocated memory
-    this->cmdbuf = dk::CmdBufMaker{this->device}.create();
-    const CMemPool::Handle cmdmem = this->pool_data->allocate(this->StaticCmdSize);
-    this->cmdbuf.addMemory(cmdmem.getMemBlock(), cmdmem.getOffset(), cmdmem.getSize());
 
-    // Create the framebuffer resources
-    this->createFramebufferResources();
+    // cpu only work, runs alongside the gpu setup.
+    const auto fonts_queried = graph.Add("pl.fonts", Where::Worker, {}, [&]{
+        plGetSharedFontByType(&font_standard, PlSharedFontType_Standard);
+        plGetSharedFontByType(&font_extended, PlSharedFontType_NintendoExt);
+    });
+
+    const auto device_created = graph.Add("dk.device", Where::Main, {}, [this]{
+        // Create the deko3d device
+        this->device = dk::DeviceMaker{}.create();
+
+        // Create the main queue
+        this->queue = dk::QueueMaker{this->device}.setFlags(DkQueueFlags_Graphics).create();
+
+        // Create the memory pools
+        this->pool_images.emplace(this->device, DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 16*1024*1024);
+        this->pool_code.emplace(this->device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Code, 128*1024);
+        this->pool_data.emplace(this->device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 1*1024*1024);
+
+        // Create the static command buffer and feed it freshly allocated memory
+        this->cmdbuf = dk::CmdBufMaker{this->device}.create();
+        const CMemPool::Handle cmdmem = this->pool_data->allocate(this->StaticCmdSize);
+        this->cmdbuf.addMemory(cmdmem.getMemBlock(), cmdmem.getOffset(), cmdmem.getSize());
+    });
+
+    const auto framebuffers_created = graph.Add("dk.framebuffers", Where::Main, {device_created}, [this]{
+        // Create the framebuffer resources
+        this->createFramebufferResources();
+    });
+
+    const auto vg_created = graph.Add("nvg.renderer", Where::Main, {framebuffers_created}, [this]{
+        // loads the shaders from romfs
+        this->renderer.emplace(1280, 720, this->device, this->queue, *this->pool_images, *this->pool_code, *this->pool_data);
+        this->vg = nvgCreateDk(&*this->renderer, NVG_ANTIALIAS | NVG_STENCIL_STROKES);
+    });
+
+    graph.Add("nvg.fonts", Where::Main, {vg_created, fonts_queried}, [&]{
+        // not sure if these are meant to be deleted or not...
+        int standard_font = nvgCreateFontMem(this->vg, "Standard", (unsigned char*)font_standard.address, font_standard.size, 0);
+        int extended_font = nvgCreateFontMem(this->vg, "Extended", (unsigned char*)font_extended.address, font_extended.size, 0);
+
+        if (standard_font < 0) {
+            LOG("failed to load Standard font\n");
+        }
+        if (extended_font < 0) {
+            LOG("failed to load extended font\n");
+        }
 
-    this->renderer.emplace(1280, 720, this->device, this->queue, *this->pool_images, *this->pool_code, *this->pool_data);
-    this->vg = nvgCreateDk(&*this->renderer, NVG_ANTIALIAS | NVG_STENCIL_STROKES);
+        nvgAddFallbackFontId(this->vg, standard_font, extended_font);
+    });
 
-    // not sure if these are meant to be deleted or not...
-    int standard_font = nvgCreateFontMem(this->vg, "Standard", (unsigned char*)font_standard.address, font_standard.size, 0);
-    int extended_font = nvgCreateFontMem(this->vg, "Extended", (unsigned char*)font_extended.address, font_extended.size, 0);
+    graph.Add("nvg.default_icon", Where::Main, {vg_created}, [this]{
+        // decoded at build time, so this is just an upload.
+        this->default_icon_image = gfx::createImageRaw(this->vg, default_icon_bin, default_icon_bin_size, NVG_IMAGE_NEAREST);
+        if (!this->default_icon_image) {
+            LOG("failed to create default icon\n");
+        }
+    });
 
-    if (standard_font < 0) {
-        LOG("failed to load Standard font\n");
-    }
-    if (extended_font < 0) {
-        LOG("failed to load extended font\n");
-    }
+    graph.Add("hid.pad", Where::Main, {}, [this]{
+        padConfigureInput(1, HidNpadStyleSet_NpadStandard);
+        padInitializeDefault(&this->pad);
+    });
 
-    nvgAddFallbackFontId(this->vg, standard_font, extended_font);
-    this->default_icon_image = nvgCreateImage(this->vg, "romfs:/default_icon.jpg", NVG_IMAGE_NEAREST);
+    graph.Run();
+    graph.LogReport();
 
-    padConfigureInput(1, HidNpadStyleSet_NpadStandard);
-    padInitializeDefault(&this->pad);
+    this->scan_progress.Register();
 }
 
 App::~App() {
     if (this->async_thread.valid()) {
         this->async_thread.request_stop();
+        // the continuation is posted to the dispatcher, so keep running it.
+        this->dispatcher.run_until_ready(this->async_thread);
         this->async_thread.get();
     }
 
-    for (auto&p : this->entries) {
-        if (p.own_image) {
-            nvgDeleteImage(this->vg, p.image);
+    if (this->sort_thread.valid()) {
+        this->dispatcher.run_until_ready(this->sort_thread);
+        this->sort_thread.get();
+    }
+
+    if (this->search_thread.valid()) {
+        this->dispatcher.run_until_ready(this->search_thread);
+        this->search_thread.get();
+    }
+
+    if (this->users_thread.valid()) {
+        this->users_thread.request_stop();
+        this->dispatcher.run_until_ready(this->users_thread);
+        this->users_thread.get();
+    }
+
+    // free whatever the scan queued but the ui didn't get to.
+    this->MergeScanned();
+    this->scan_progress.Unregister();
+
+    for (TitleTable::Row row = 0; row < this->titles.Size(); row++) {
+        if (this->titles.Flags(row) & TitleTable::Flag_OwnImage) {
+            nvgDeleteImage(this->vg, this->titles.Image(row));
         }
     }
 
+    this->heatmap.Destroy(this->vg);
     nvgDeleteImage(this->vg, default_icon_image);
     this->destroyFramebufferResources();
     nvgDeleteDk(this->vg);
@@ -3,13 +3,29 @@
 #include "nanovg/nanovg.h"
 #include "nanovg/deko3d/dk_renderer.hpp"
 #include "async.hpp"
+#include "task.hpp"
+#include "spsc_queue.hpp"
 #include "playtime.hpp"
 #include "controller.hpp"
+#include "scan_progress.hpp"
+#include "play_events.hpp"
+#include "heatmap.hpp"
+#include "metadata_cache.hpp"
+#include "user_matrix.hpp"
+#include "title_table.hpp"
+#include "search_index.hpp"
+#include "filter_query.hpp"
+#include "playtime_stats.hpp"
+#include "author_groups.hpp"
+#include "instrumentation.hpp"
 
 #include <switch.h>
 #include <cstdint>
+#include <array>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <span>
 #include <future>
 #include <mutex>
 #include <optional>
@@ -19,19 +35,7 @@
 
 namespace tj {
 
-using AppID = std::uint64_t;
-
-enum class MenuMode { LOAD, LIST };
-
-struct AppEntry final {
-    std::string name;
-    std::string author;
-    std::string display_version;
-    Playtime playtime;
-    AppID id;
-    int image;
-    bool own_image{false};
-};
+enum class MenuMode { LOAD, LIST, HEATMAP, USERS, SEARCH, STATS, AUTHORS };
 
 class App final {
 public:
@@ -44,14 +48,64 @@ public:
 
 private:
     NVGcontext* vg{nullptr};
-    std::vector<AppEntry> entries;
+    TitleTable titles{}; // main thread only
+    // scanned entries are handed to the main thread through here.
+    util::SpscQueue<AppEntry, 64> scanned_entries{};
+    // set while the scan waits for room in the queue, fired once drained.
+    std::mutex scanned_space_mutex{};
+    std::optional<util::AsyncPromise<void>> scanned_space{}; // scanned_space_mutex locked
     PadState pad{};
     Controller controller{};
     AccountUid account_uid;
+    // fulfilled once the user has been picked, the scan waits on it.
+    util::AsyncPromise<AccountUid> account_promise{};
 
     util::AsyncFuture<void> async_thread;
-    std::mutex mutex{};
-    bool finished_scanning{false}; // mutex locked
+    ScanProgress scan_progress{};
+    ScanProgress::Snapshot progress{}; // sampled once per frame
+    // continuations that touch app state are posted here, ran once per frame.
+    util::Dispatcher dispatcher{};
+    // written by the scan, only read once it has finished.
+    PlayHistory history{};
+    MetadataCache metadata_cache{}; // scan only
+    Heatmap heatmap{};
+    int heatmap_year{};
+    bool heatmap_all{false}; // every title instead of the selected one
+
+    // every user side by side, scanned the first time the view is opened.
+    util::AsyncFuture<void> users_thread;
+    UserMatrix user_matrix{};
+    std::vector<std::string> user_matrix_names{}; // per matrix title
+    std::vector<std::uint32_t> user_matrix_order{};
+    std::size_t user_matrix_column{};
+    std::size_t user_matrix_index{};
+    std::size_t user_matrix_start{};
+
+    // search, rerun on every key typed on the on screen keyboard.
+    util::AsyncFuture<void> search_thread;
+    SearchIndex search_index{}; // built once the scan is done
+    std::string search_query{};
+    std::vector<TitleTable::Row> search_results{};
+    std::size_t search_key{}; // selected keyboard key
+    std::size_t search_selected{};
+    std::size_t search_start{};
+    util::instrument::Nanoseconds search_time{};
+
+    // only rows passing the filter are listed, the mask is empty without one.
+    std::optional<FilterQuery> filter{};
+    std::vector<std::uint8_t> filter_mask{}; // per row
+    std::string filter_error{};
+    std::vector<std::uint32_t> last_played{}; // per row, day or 0 if never
+
+    // stats of the listed titles, rebuilt when the list content changes.
+    std::optional<PlaytimeStats> stats{};
+    std::uint32_t stats_generation{};
+
+    // listed titles grouped by author, opened from the stats screen.
+    std::optional<AuthorGroups> author_groups{};
+    std::uint32_t author_groups_generation{};
+    std::size_t author_line{};
+    std::size_t author_start{};
 
     // this is just bad code, ignore it
     static constexpr float BOX_HEIGHT{120.f};
@@ -62,6 +116,7 @@ private:
     MenuMode menu_mode{MenuMode::LOAD};
     int default_icon_image{};
     bool has_corrupted{false};
+    bool show_uninstalled{true};
     bool quit{false};
 
     enum class SortType {
@@ -74,21 +129,68 @@ private:
 
     uint8_t sort_type{std::to_underlying(SortType::Playtime_BigSmall)};
 
+    // rows shown in the list in display order, and where each row ended up.
+    struct SortedOrder {
+        static constexpr std::uint32_t NOT_SHOWN{UINT32_MAX};
+        std::vector<TitleTable::Row> rows;
+        std::vector<std::uint32_t> positions; // per row
+    };
+
+    // past this many titles, sorting is done on the pool.
+    static constexpr std::size_t BACKGROUND_SORT_MIN{2000};
+    // built the first time a sort type is picked, dropped if the filter changes.
+    std::array<std::optional<SortedOrder>, std::to_underlying(SortType::MAX)> sort_cache{};
+    std::uint32_t sort_generation{};
+    util::AsyncFuture<void> sort_thread;
+
     void Draw();
     void Update();
     void Poll();
-    void Scan(std::stop_token stop_token); // called on init
+    util::Task<void> Scan(util::AsyncFuture<AccountUid> account); // called on init
+    void MergeScanned();
+    util::AsyncFuture<void> WaitScannedSpace();
+    void SignalScannedSpace();
+    util::Task<std::vector<NsApplicationRecord>> ListRecords();
+    util::Task<AppEntry> LoadMetadata(AppID application_id, NsApplicationControlData& control_data);
+    bool QueryPlaytime(AppEntry& entry, AccountUid uid);
+    std::optional<u64> QueryPlaytimeSeconds(AppID application_id, AccountUid uid);
+    std::optional<PlaytimeEngine> LoadPlayEvents(AccountUid uid, std::stop_token stop_token);
+    void MarkCorrupted(AppEntry& entry);
+    AppEntry LoadUninstalled(AppID application_id, u64 playtime_seconds);
+    void ToggleUninstalled();
+    util::Task<int> DecodeIcon(NsApplicationControlData& control_data, u64 jpeg_size);
     void Sort();
+    void ChangeSort(SortType type);
+    void ApplySort(SortType type);
+    void SelectRow(TitleTable::Row row);
+    void SpawnSearchIndex();
+    void RunSearch();
+    const std::vector<TitleTable::Row>& Order() const;
+    static SortedOrder BuildOrder(const TitleTable& titles, SortType type, bool show_uninstalled, std::span<const std::uint8_t> filter_mask);
+    bool AnyShown(bool show_uninstalled, std::span<const std::uint8_t> filter_mask) const;
+    void EditFilter();
+    void SetFilter(std::string_view text);
+    void SpawnUsersScan();
+    util::Task<UserMatrix> ScanUsers(std::vector<AppID> titles);
     const char* GetSortStr();
 
     void UpdateLoad();
     void UpdateList();
-    void UpdateConfirm();
+    void UpdateHeatmap();
+    void UpdateUsers();
+    void UpdateSearch();
+    void UpdateStats();
+    void UpdateAuthors();
     void UpdateProgress();
 
     void DrawBackground();
     void DrawLoad();
     void DrawList();
+    void DrawHeatmap();
+    void DrawUsers();
+    void DrawSearch();
+    void DrawStats();
+    void DrawAuthors();
 
 private: // from nanovg decko3d example by adubbz
     static constexpr unsigned NumFramebuffers = 2;
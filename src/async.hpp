@@ -1,24 +1,124 @@
 #pragma once
 
+#include <cassert>
 #include <future>
 #include <stop_token>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <optional>
+
+#ifdef __SWITCH__
+    #include <switch.h>
+#endif // __SWITCH__
 
 namespace util {
 
+// lower value runs first.
+enum class Priority : std::uint8_t {
+    High,   // work the user is waiting on, eg decoding visible icons.
+    Normal,
+    Low,    // background work, eg rescanning.
+    MAX,
+};
+
+// unit of work ran by an executor.
+using Job = std::move_only_function<void()>;
+
+namespace detail {
+
+// fired once the value of a future has been set.
+// callbacks run on the thread that sets the value, or straight away
+// if it has already been set.
+class Completion final {
+public:
+    void on_complete(Job&& fn) {
+        std::unique_lock lock{this->mutex};
+        if (this->done) {
+            lock.unlock();
+            fn();
+        } else {
+            this->callbacks.emplace_back(std::move(fn));
+        }
+    }
+
+    void complete() {
+        std::vector<Job> list;
+        {
+            std::scoped_lock lock{this->mutex};
+            this->done = true;
+            list = std::move(this->callbacks);
+        }
+        for (auto& fn : list) {
+            fn();
+        }
+    }
+
+private:
+    std::mutex mutex{};
+    std::vector<Job> callbacks{}; // mutex locked
+    bool done{false}; // mutex locked
+};
+
+// calls a continuation with the value of a ready future, passing the
+// stop token first if the continuation takes one.
+template<typename Fn, typename T>
+decltype(auto) invoke_continuation(Fn& fn, std::stop_token stop_token, std::future<T>& future) {
+    if constexpr (std::is_void_v<T>) {
+        future.get();
+        if constexpr (std::is_invocable_v<Fn&, std::stop_token>) {
+            return std::invoke(fn, std::move(stop_token));
+        } else {
+            return std::invoke(fn);
+        }
+    } else {
+        if constexpr (std::is_invocable_v<Fn&, std::stop_token, T>) {
+            return std::invoke(fn, std::move(stop_token), future.get());
+        } else {
+            return std::invoke(fn, future.get());
+        }
+    }
+}
+
+template<typename T, typename Fn, typename... Args>
+void set_promise(std::promise<T>& promise, Fn&& fn, Args&&... args) {
+    if constexpr (std::is_void_v<T>) {
+        std::invoke(std::forward<Fn>(fn), std::forward<Args>(args)...);
+        promise.set_value();
+    } else {
+        promise.set_value(std::invoke(std::forward<Fn>(fn), std::forward<Args>(args)...));
+    }
+}
+
+} // namespace detail
+
 // simple wrapper for future + stop token.
-// todo: write my own std::async with token source added, like jthread.
+// continuations can be attached to any future that isn't default
+// constructed or moved from, whoever sets the value signals completion.
 template<typename T>
 class AsyncFuture {
 public:
     constexpr AsyncFuture() = default;
     constexpr AsyncFuture(AsyncFuture&& token)
     : future{std::move(token.future)}
-    , stop_source{std::move(token.stop_source)} {}
-    constexpr AsyncFuture(std::future<T>&& f)
-    : future{std::forward<std::future<T>>(f)} {}
-    constexpr AsyncFuture(std::future<T>&& f, std::stop_source&& ss)
+    , stop_source{std::move(token.stop_source)}
+    , completion{std::move(token.completion)} {}
+    AsyncFuture(std::future<T>&& f, std::stop_source&& ss, std::shared_ptr<detail::Completion> c)
     : future{std::forward<std::future<T>>(f)}
-    , stop_source{std::forward<std::stop_source>(ss)} {}
+    , stop_source{std::forward<std::stop_source>(ss)}
+    , completion{std::move(c)} {}
     ~AsyncFuture() {
         if (this->future.valid()) {
             this->stop_source.request_stop();
@@ -33,6 +133,7 @@ public:
     AsyncFuture<T>& operator=(AsyncFuture<T>&& f) noexcept {
         this->future = std::move(f.future);
         this->stop_source = std::move(f.stop_source);
+        this->completion = std::move(f.completion);
         return *this;
     }
 
@@ -46,6 +147,11 @@ public:
         return this->stop_source.get_token();
     }
 
+    [[nodiscard]]
+    auto get_stop_source() const noexcept {
+        return this->stop_source;
+    }
+
     auto request_stop() {
         return this->stop_source.request_stop();
     }
@@ -77,31 +183,445 @@ public:
         return this->future.valid();
     }
 
+    // non-blocking, true once get() would return straight away.
+    [[nodiscard]]
+    auto is_ready() const {
+        return this->future.valid() && this->future.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+    }
+
+    // fn runs on the thread that sets the value, the future stays valid.
+    void on_complete(Job&& fn) {
+        assert(this->completion && "future has no completion");
+        this->completion->on_complete(std::move(fn));
+    }
+
+    // posts fn to the executor once the value is ready, fn is called with
+    // (std::stop_token, T), (T), (std::stop_token) or () for void.
+    // this future is consumed and the returned one shares its stop source.
+    template<typename Executor, typename Fn>
+    auto then(Executor& executor, Fn&& fn, Priority priority = Priority::Normal) && {
+        using U = decltype(detail::invoke_continuation(std::declval<std::decay_t<Fn>&>(), std::declval<std::stop_token>(), std::declval<std::future<T>&>()));
+
+        std::promise<U> promise;
+        auto next = promise.get_future();
+        assert(this->completion && "future has no completion");
+        auto next_completion = std::make_shared<detail::Completion>();
+        auto completion = std::move(this->completion);
+
+        completion->on_complete([&executor, priority, future = std::move(this->future), stop_token = this->stop_source.get_token(), promise = std::move(promise), fn = std::forward<Fn>(fn), next_completion]() mutable {
+            executor.post([future = std::move(future), stop_token = std::move(stop_token), promise = std::move(promise), fn = std::move(fn), next_completion = std::move(next_completion)]() mutable {
+                detail::set_promise(promise, [&]() -> U {
+                    return detail::invoke_continuation(fn, std::move(stop_token), future);
+                });
+                next_completion->complete();
+            }, priority);
+        });
+
+        return AsyncFuture<U>{std::move(next), std::move(this->stop_source), std::move(next_completion)};
+    }
+
 private:
     std::future<T> future{};
     std::stop_source stop_source{};
+    std::shared_ptr<detail::Completion> completion{};
+};
+
+// promise side of an AsyncFuture, for values that don't come from a task,
+// eg something the main thread finds out.
+template<typename T>
+class AsyncPromise final {
+public:
+    [[nodiscard]]
+    auto get_future() {
+        return AsyncFuture<T>{this->promise.get_future(), std::stop_source{}, this->completion};
+    }
+
+    template<typename... Args>
+    void set_value(Args&&... args) {
+        // the waiter may destroy this as soon as the value is set.
+        const auto completion = this->completion;
+        this->promise.set_value(std::forward<Args>(args)...);
+        completion->complete();
+    }
+
+private:
+    std::promise<T> promise{};
+    std::shared_ptr<detail::Completion> completion{std::make_shared<detail::Completion>()};
 };
 
 template<typename Fn, typename... Args>
 using AsyncResult = typename std::invoke_result<
     typename std::decay<Fn>::type, typename std::decay<Args>::type...>::type;
 
-// enabled if function DOES start with std::stop_token
-template<typename Fn, typename... Args, typename = std::enable_if<std::is_invocable_v<std::decay_t<Fn>, std::stop_token, std::decay_t<Args>...>>>
-auto async(Fn&& fn, Args&&... args) -> AsyncFuture<AsyncResult<Fn, std::stop_token, Args...>> {
+// persistent pool of worker threads.
+// each worker owns a queue per priority, if a worker runs dry it steals
+// from the other workers, highest priority first.
+class ThreadPool final {
+public:
+    // thread_count of 0 uses one worker per core.
+    // core_mask of 0 lets the os decide where the workers run, otherwise
+    // each worker is pinned to the next core set in the mask.
+    explicit ThreadPool(std::size_t thread_count = 0, std::uint64_t core_mask = 0) {
+        if (thread_count == 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        this->workers.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; i++) {
+            this->workers.emplace_back(std::make_unique<Worker>());
+        }
+
+        // start after all workers exist as they steal from each other.
+        for (std::size_t i = 0; i < thread_count; i++) {
+            this->workers[i]->thread = std::jthread{[this, i, core_mask](std::stop_token stop_token) {
+                this->Run(stop_token, i, core_mask);
+            }};
+        }
+    }
+
+    ~ThreadPool() {
+        for (auto& worker : this->workers) {
+            worker->thread.request_stop();
+        }
+        // workers drain the queues before exiting, so every future is fulfilled.
+        for (auto& worker : this->workers) {
+            worker->thread.join();
+        }
+    }
+
+    // disable copying
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // pool used by util::async.
+    static ThreadPool& get_default() {
+#ifdef __SWITCH__
+        // applications may only use cores 0-2, core 3 belongs to the system.
+        static ThreadPool pool{3, 0b111};
+#else
+        static ThreadPool pool{};
+#endif // __SWITCH__
+        return pool;
+    }
+
+    [[nodiscard]]
+    auto size() const noexcept {
+        return this->workers.size();
+    }
+
+    // fire and forget.
+    void post(Job&& task, Priority priority = Priority::Normal) {
+        std::size_t index;
+        if (current_pool == this) {
+            // keep work spawned from a worker local to it.
+            index = current_index;
+        } else {
+            index = this->next.fetch_add(1, std::memory_order_relaxed) % this->workers.size();
+        }
+
+        {
+            auto& worker = *this->workers[index];
+            std::scoped_lock lock{worker.mutex};
+            worker.queues[std::to_underlying(priority)].emplace_back(std::move(task));
+        }
+
+        this->pending.fetch_add(1, std::memory_order_release);
+        // lock so that the wakeup can't slip in between a worker checking
+        // pending and going to sleep.
+        { std::scoped_lock lock{this->sleep_mutex}; }
+        this->sleep_cv.notify_one();
+    }
+
+    // enabled if function DOES start with std::stop_token
+    template<typename Fn, typename... Args>
+    requires std::is_invocable_v<std::decay_t<Fn>, std::stop_token, std::decay_t<Args>...>
+    auto submit(Priority priority, Fn&& fn, Args&&... args) -> AsyncFuture<AsyncResult<Fn, std::stop_token, Args...>> {
+        std::stop_source source_token;
+        auto token = source_token.get_token();
+        return this->Submit<AsyncResult<Fn, std::stop_token, Args...>>(std::move(source_token), priority, std::forward<Fn>(fn), std::move(token), std::forward<Args>(args)...);
+    }
+
+    // enabled if function does NOT start with std::stop_token
+    template<typename Fn, typename... Args>
+    requires (!std::is_invocable_v<std::decay_t<Fn>, std::stop_token, std::decay_t<Args>...>)
+    auto submit(Priority priority, Fn&& fn, Args&&... args) -> AsyncFuture<AsyncResult<Fn, Args...>> {
+        return this->Submit<AsyncResult<Fn, Args...>>(std::stop_source{}, priority, std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex{};
+        std::array<std::deque<Job>, std::to_underlying(Priority::MAX)> queues{}; // mutex locked
+        std::jthread thread{};
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers{};
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> next{0};
+    std::mutex sleep_mutex{};
+    std::condition_variable_any sleep_cv{};
+
+    static inline thread_local ThreadPool* current_pool{nullptr};
+    static inline thread_local std::size_t current_index{0};
+
+    template<typename T, typename Fn, typename... Args>
+    auto Submit(std::stop_source&& source_token, Priority priority, Fn&& fn, Args&&... args) -> AsyncFuture<T> {
+        std::promise<T> promise;
+        auto future = promise.get_future();
+        auto completion = std::make_shared<detail::Completion>();
+
+        this->post([promise = std::move(promise), completion, fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)]() mutable {
+            detail::set_promise(promise, std::move(fn), std::move(args)...);
+            completion->complete();
+        }, priority);
+
+        return AsyncFuture<T>{std::move(future), std::move(source_token), std::move(completion)};
+    }
+
+    bool TryPop(std::size_t index, Job& out) {
+        for (std::size_t p = 0; p < std::to_underlying(Priority::MAX); p++) {
+            // own queue first, oldest task first.
+            {
+                auto& worker = *this->workers[index];
+                std::scoped_lock lock{worker.mutex};
+                if (auto& queue = worker.queues[p]; !queue.empty()) {
+                    out = std::move(queue.front());
+                    queue.pop_front();
+                    return true;
+                }
+            }
+
+            // steal from the back so the owner keeps its oldest work.
+            for (std::size_t i = 1; i < this->workers.size(); i++) {
+                auto& victim = *this->workers[(index + i) % this->workers.size()];
+                std::scoped_lock lock{victim.mutex};
+                if (auto& queue = victim.queues[p]; !queue.empty()) {
+                    out = std::move(queue.back());
+                    queue.pop_back();
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void Run(std::stop_token stop_token, std::size_t index, [[maybe_unused]] std::uint64_t core_mask) {
+        current_pool = this;
+        current_index = index;
+
+#ifdef __SWITCH__
+        if (core_mask) {
+            // pick the n-th set core in the mask, wrapping around.
+            const auto cores = static_cast<std::size_t>(__builtin_popcountll(core_mask));
+            auto nth = index % cores;
+            s32 core = 0;
+            for (auto mask = core_mask; mask; mask &= mask - 1, nth--) {
+                if (nth == 0) {
+                    core = __builtin_ctzll(mask);
+                    break;
+                }
+            }
+            svcSetThreadCoreMask(CUR_THREAD_HANDLE, core, static_cast<u32>(core_mask));
+        }
+#endif // __SWITCH__
+
+        for (;;) {
+            Job task;
+            if (this->TryPop(index, task)) {
+                this->pending.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+                continue;
+            }
+
+            if (stop_token.stop_requested() && this->pending.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+
+            std::unique_lock lock{this->sleep_mutex};
+            this->sleep_cv.wait(lock, stop_token, [this]{
+                return this->pending.load(std::memory_order_acquire) != 0;
+            });
+        }
+    }
+};
+
+// runs tasks on whichever thread calls run_pending(), eg the main loop.
+class Dispatcher final {
+public:
+    void post(Job&& task, Priority priority = Priority::Normal) {
+        {
+            std::scoped_lock lock{this->mutex};
+            this->queues[std::to_underlying(priority)].emplace_back(std::move(task));
+        }
+        this->cv.notify_all();
+    }
+
+    // runs the tasks queued so far, highest priority first.
+    // tasks posted while running wait for the next call.
+    void run_pending() {
+        decltype(this->queues) list;
+        {
+            std::scoped_lock lock{this->mutex};
+            std::swap(list, this->queues);
+        }
+        for (auto& queue : list) {
+            for (auto& task : queue) {
+                task();
+            }
+        }
+    }
+
+    // blocks until the future is ready, running tasks in the meantime
+    // in case the future is waiting on one of them.
+    template<typename T>
+    void run_until_ready(AsyncFuture<T>& future) {
+        while (!future.is_ready()) {
+            this->run_pending();
+            std::unique_lock lock{this->mutex};
+            this->cv.wait_for(lock, std::chrono::milliseconds{1}, [this]{
+                return std::ranges::any_of(this->queues, [](auto& queue){ return !queue.empty(); });
+            });
+        }
+    }
+
+private:
+    std::mutex mutex{};
+    std::condition_variable cv{};
+    std::array<std::vector<Job>, std::to_underlying(Priority::MAX)> queues{}; // mutex locked
+};
+
+// runs fn on the default thread pool.
+template<typename Fn, typename... Args>
+auto async(Fn&& fn, Args&&... args) {
+    return ThreadPool::get_default().submit(Priority::Normal, std::forward<Fn>(fn), std::forward<Args>(args)...);
+}
+
+// WhenAny value, index is the first future to become ready.
+template<typename T>
+struct WhenAnyResult {
+    std::size_t index;
+    std::vector<AsyncFuture<T>> futures;
+};
+
+// ready once all futures are ready, holds their values in order.
+// stopping the returned future stops all of them.
+template<typename T>
+auto when_all(std::vector<AsyncFuture<T>>&& futures) {
+    using U = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+
+    struct State {
+        std::vector<AsyncFuture<T>> futures;
+        std::promise<U> promise{};
+        std::shared_ptr<detail::Completion> completion{std::make_shared<detail::Completion>()};
+        std::atomic<std::size_t> remaining{0};
+        std::optional<std::stop_callback<std::function<void()>>> on_stop{};
+    };
+
+    auto state = std::make_shared<State>();
+    state->futures = std::move(futures);
+    // +1 for registering below, so that nothing completes until we're done.
+    state->remaining.store(state->futures.size() + 1, std::memory_order_relaxed);
     std::stop_source source_token;
-    return AsyncFuture{
-        std::async(std::launch::async, std::forward<Fn>(fn), source_token.get_token(), std::forward<Args>(args)...),
-        std::move(source_token)
+    auto next = state->promise.get_future();
+    auto completion = state->completion;
+
+    std::vector<std::stop_source> sources;
+    for (auto& future : state->futures) {
+        sources.emplace_back(future.get_stop_source());
+    }
+    state->on_stop.emplace(source_token.get_token(), [sources = std::move(sources)]() mutable {
+        for (auto& source : sources) {
+            source.request_stop();
+        }
+    });
+
+    const auto arrive = [](const std::shared_ptr<State>& state) {
+        if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        if constexpr (std::is_void_v<T>) {
+            for (auto& future : state->futures) {
+                future.get();
+            }
+            state->promise.set_value();
+        } else {
+            std::vector<T> values;
+            values.reserve(state->futures.size());
+            for (auto& future : state->futures) {
+                values.emplace_back(future.get());
+            }
+            state->promise.set_value(std::move(values));
+        }
+        state->completion->complete();
     };
+
+    for (auto& future : state->futures) {
+        future.on_complete([state, arrive]{ arrive(state); });
+    }
+    arrive(state);
+
+    return AsyncFuture<U>{std::move(next), std::move(source_token), std::move(completion)};
 }
 
-// enabled if function does NOT start with std::stop_token
-template<typename Fn, typename... Args, typename = std::enable_if<!std::is_invocable_v<std::decay_t<Fn>, std::stop_token, std::decay_t<Args>...>>>
-auto async(Fn&& fn, Args&&... args) -> AsyncFuture<AsyncResult<Fn, Args...>> {
-    return AsyncFuture{
-        std::async(std::launch::async, std::forward<Fn>(fn), std::forward<Args>(args)...)
+// ready once any of the futures is ready, the futures are handed back
+// so the others can still be waited on.
+// stopping the returned future stops all of them.
+template<typename T>
+auto when_any(std::vector<AsyncFuture<T>>&& futures) {
+    using U = WhenAnyResult<T>;
+
+    struct State {
+        std::vector<AsyncFuture<T>> futures;
+        std::promise<U> promise{};
+        std::shared_ptr<detail::Completion> completion{std::make_shared<detail::Completion>()};
+        std::atomic<std::size_t> index{SIZE_MAX};
+        std::atomic<std::size_t> arrivals{0};
+        std::optional<std::stop_callback<std::function<void()>>> on_stop{};
+    };
+
+    auto state = std::make_shared<State>();
+    state->futures = std::move(futures);
+    std::stop_source source_token;
+    auto next = state->promise.get_future();
+    auto completion = state->completion;
+
+    std::vector<std::stop_source> sources;
+    for (auto& future : state->futures) {
+        sources.emplace_back(future.get_stop_source());
+    }
+    state->on_stop.emplace(source_token.get_token(), [sources = std::move(sources)]() mutable {
+        for (auto& source : sources) {
+            source.request_stop();
+        }
+    });
+
+    // fulfilled by whichever comes second, the first ready future or
+    // the end of registering below.
+    const auto arrive = [](const std::shared_ptr<State>& state) {
+        if (state->arrivals.fetch_add(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        state->promise.set_value(U{state->index.load(std::memory_order_acquire), std::move(state->futures)});
+        state->completion->complete();
     };
+
+    for (std::size_t i = 0; i < state->futures.size(); i++) {
+        state->futures[i].on_complete([state, arrive, i]{
+            auto expected = SIZE_MAX;
+            if (state->index.compare_exchange_strong(expected, i, std::memory_order_acq_rel)) {
+                arrive(state);
+            }
+        });
+    }
+
+    if (state->futures.empty()) {
+        state->arrivals.fetch_add(1, std::memory_order_relaxed);
+    }
+    arrive(state);
+
+    return AsyncFuture<U>{std::move(next), std::move(source_token), std::move(completion)};
 }
 
 } // namespace util
@@ -0,0 +1,92 @@
+#include "author_groups.hpp"
+#include "flat_map.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace tj {
+
+auto AuthorGroups::Build(const TitleTable& titles, std::span<const TitleTable::Row> rows, std::span<const std::uint32_t> last_played) -> AuthorGroups {
+    AuthorGroups result;
+    auto& groups = result.groups;
+
+    // one pass to aggregate, the map only holds the authors actually listed.
+    util::FlatMap<std::uint32_t, std::uint32_t> lookup;
+    std::vector<std::uint32_t> row_groups;
+    row_groups.reserve(rows.size());
+    for (const auto row : rows) {
+        const auto author = titles.AuthorId(row);
+        const auto [group, inserted] = lookup.try_emplace(author, static_cast<std::uint32_t>(groups.size()));
+        if (inserted) {
+            groups.emplace_back(author, 0, 0, 0);
+        }
+
+        auto& g = groups[*group];
+        g.count++;
+        g.seconds += titles.Seconds(row);
+        if (row < last_played.size()) {
+            g.last_played = std::max(g.last_played, last_played[row]);
+        }
+        row_groups.emplace_back(*group);
+    }
+
+    // most played first, ties by author name.
+    std::vector<std::uint32_t> order(groups.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&](auto a, auto b) {
+        if (groups[a].seconds != groups[b].seconds) {
+            return groups[a].seconds > groups[b].seconds;
+        }
+        return titles.AuthorById(groups[a].author) < titles.AuthorById(groups[b].author);
+    });
+
+    std::vector<std::uint32_t> rank(groups.size());
+    std::vector<Group> sorted(groups.size());
+    for (std::uint32_t i = 0; i < order.size(); i++) {
+        rank[order[i]] = i;
+        sorted[i] = groups[order[i]];
+    }
+    groups = std::move(sorted);
+
+    // counting sort of the rows into their groups, keeping the given order.
+    result.offsets.assign(groups.size() + 1, 0);
+    for (std::size_t i = 0; i < groups.size(); i++) {
+        result.offsets[i + 1] = result.offsets[i] + groups[i].count;
+    }
+
+    auto next = result.offsets;
+    result.rows.resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); i++) {
+        result.rows[next[rank[row_groups[i]]]++] = rows[i];
+    }
+
+    result.expanded.assign(groups.size(), 0);
+    result.line_starts.assign(groups.size() + 1, 0);
+    result.UpdateLines(0);
+    return result;
+}
+
+auto AuthorGroups::Titles(std::size_t group) const -> std::span<const TitleTable::Row> {
+    return std::span{this->rows}.subspan(this->offsets[group], this->offsets[group + 1] - this->offsets[group]);
+}
+
+void AuthorGroups::Toggle(std::size_t group) {
+    this->expanded[group] ^= 1;
+    this->UpdateLines(group);
+}
+
+auto AuthorGroups::LineAt(std::size_t line) const -> Line {
+    // the last group whose header is at or before the line.
+    const auto it = std::upper_bound(this->line_starts.begin(), this->line_starts.end() - 1, line);
+    const auto group = static_cast<std::uint32_t>(it - this->line_starts.begin() - 1);
+    const auto offset = line - this->line_starts[group];
+    return {group, offset == 0 ? HEADER : static_cast<std::uint32_t>(offset - 1)};
+}
+
+void AuthorGroups::UpdateLines(std::size_t first) {
+    for (auto group = first; group < this->groups.size(); group++) {
+        this->line_starts[group + 1] = this->line_starts[group] + 1 + (this->expanded[group] ? this->groups[group].count : 0);
+    }
+}
+
+} // namespace tj
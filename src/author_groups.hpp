@@ -0,0 +1,58 @@
+#pragma once
+
+#include "title_table.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace tj {
+
+// listed titles grouped by author, with playtime, title count and the
+// last day played summed up per author, most played author first.
+// groups can be collapsed, the list is then a sequence of lines, a header
+// per group followed by its titles if expanded. lines are never built,
+// LineAt() finds the group with a binary search over where each group
+// starts, so a big expanded group costs nothing until it's on screen.
+class AuthorGroups final {
+public:
+    static constexpr std::uint32_t HEADER{UINT32_MAX};
+
+    struct Group {
+        std::uint32_t author;   // TitleTable author id
+        std::uint32_t count;
+        std::uint64_t seconds;
+        std::uint32_t last_played; // day, 0 if never
+    };
+
+    struct Line {
+        std::uint32_t group;
+        std::uint32_t title; // index into Titles(group), or HEADER
+    };
+
+    // rows are kept in the order given within each group.
+    [[nodiscard]] static AuthorGroups Build(const TitleTable& titles, std::span<const TitleTable::Row> rows, std::span<const std::uint32_t> last_played);
+
+    [[nodiscard]] std::span<const Group> Groups() const { return this->groups; }
+    [[nodiscard]] std::span<const TitleTable::Row> Titles(std::size_t group) const;
+    [[nodiscard]] bool Empty() const { return this->groups.empty(); }
+
+    [[nodiscard]] bool Expanded(std::size_t group) const { return this->expanded[group]; }
+    void Toggle(std::size_t group);
+
+    [[nodiscard]] std::size_t LineCount() const { return this->line_starts.back(); }
+    [[nodiscard]] Line LineAt(std::size_t line) const;
+    [[nodiscard]] std::size_t HeaderLine(std::size_t group) const { return this->line_starts[group]; }
+
+private:
+    // only groups from first onwards move when a group is toggled.
+    void UpdateLines(std::size_t first);
+
+    std::vector<Group> groups{};
+    std::vector<std::uint32_t> offsets{};       // group -> first of its rows, one past the end last
+    std::vector<TitleTable::Row> rows{};        // grouped
+    std::vector<std::uint8_t> expanded{};       // per group
+    std::vector<std::uint32_t> line_starts{0};  // group -> line of its header, line count last
+};
+
+} // namespace tj
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+
+// appends trivially copyable values to a byte buffer, native endian.
+class ByteWriter final {
+public:
+    explicit ByteWriter(std::vector<std::uint8_t>& out) : out{out} {}
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void put(const T& value) {
+        const auto offset = this->out.size();
+        this->out.resize(offset + sizeof(T));
+        std::memcpy(this->out.data() + offset, &value, sizeof(T));
+    }
+
+    // 7 bits per byte, high bit set if more follow.
+    void put_varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            this->out.emplace_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        this->out.emplace_back(static_cast<std::uint8_t>(value));
+    }
+
+    void put_bytes(std::span<const std::uint8_t> bytes) {
+        this->out.insert(this->out.end(), bytes.begin(), bytes.end());
+    }
+
+    // length then the bytes, no terminator.
+    void put_string(std::string_view str) {
+        this->put_varint(str.size());
+        this->out.insert(this->out.end(), str.begin(), str.end());
+    }
+
+    [[nodiscard]]
+    auto size() const noexcept {
+        return this->out.size();
+    }
+
+private:
+    std::vector<std::uint8_t>& out;
+};
+
+// reads values written by ByteWriter.
+// once a read runs past the end every following read fails as well.
+class ByteReader final {
+public:
+    explicit ByteReader(std::span<const std::uint8_t> in) : in{in} {}
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    [[nodiscard]]
+    bool get(T& value) {
+        if (!this->ok || this->in.size() < sizeof(T)) {
+            this->ok = false;
+            return false;
+        }
+
+        std::memcpy(&value, this->in.data(), sizeof(T));
+        this->in = this->in.subspan(sizeof(T));
+        return true;
+    }
+
+    [[nodiscard]]
+    bool get_varint(std::uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; this->ok && shift < 64; shift += 7) {
+            if (this->in.empty()) {
+                break;
+            }
+
+            const auto byte = this->in.front();
+            this->in = this->in.subspan(1);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+
+        this->ok = false;
+        return false;
+    }
+
+    [[nodiscard]]
+    bool get_bytes(std::span<std::uint8_t> bytes) {
+        if (!this->ok || this->in.size() < bytes.size()) {
+            this->ok = false;
+            return false;
+        }
+
+        std::memcpy(bytes.data(), this->in.data(), bytes.size());
+        this->in = this->in.subspan(bytes.size());
+        return true;
+    }
+
+    [[nodiscard]]
+    bool get_string(std::string& str) {
+        std::uint64_t size{};
+        if (!this->get_varint(size) || size > this->in.size()) {
+            this->ok = false;
+            return false;
+        }
+
+        str.assign(reinterpret_cast<const char*>(this->in.data()), size);
+        this->in = this->in.subspan(size);
+        return true;
+    }
+
+    [[nodiscard]]
+    auto good() const noexcept {
+        return this->ok;
+    }
+
+    [[nodiscard]]
+    auto remaining() const noexcept {
+        return this->in.size();
+    }
+
+    // whatever hasn't been read yet.
+    [[nodiscard]]
+    auto rest() const noexcept {
+        return this->in;
+    }
+
+private:
+    std::span<const std::uint8_t> in;
+    bool ok{true};
+};
+
+} // namespace util
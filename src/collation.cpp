@@ -0,0 +1,193 @@
+#include "collation.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace util {
+namespace {
+
+struct Range {
+    char32_t first;
+    char32_t last;
+    const char* folded;
+};
+
+// latin-1 and latin extended-a letters to their base letters.
+constexpr std::array LATIN_RANGES{
+    Range{0x00C0, 0x00C5, "a"}, Range{0x00C6, 0x00C6, "ae"}, Range{0x00C7, 0x00C7, "c"},
+    Range{0x00C8, 0x00CB, "e"}, Range{0x00CC, 0x00CF, "i"}, Range{0x00D0, 0x00D0, "d"},
+    Range{0x00D1, 0x00D1, "n"}, Range{0x00D2, 0x00D6, "o"}, Range{0x00D8, 0x00D8, "o"},
+    Range{0x00D9, 0x00DC, "u"}, Range{0x00DD, 0x00DD, "y"}, Range{0x00DF, 0x00DF, "ss"},
+    Range{0x00E0, 0x00E5, "a"}, Range{0x00E6, 0x00E6, "ae"}, Range{0x00E7, 0x00E7, "c"},
+    Range{0x00E8, 0x00EB, "e"}, Range{0x00EC, 0x00EF, "i"}, Range{0x00F0, 0x00F0, "d"},
+    Range{0x00F1, 0x00F1, "n"}, Range{0x00F2, 0x00F6, "o"}, Range{0x00F8, 0x00F8, "o"},
+    Range{0x00F9, 0x00FC, "u"}, Range{0x00FD, 0x00FD, "y"}, Range{0x00FF, 0x00FF, "y"},
+    Range{0x0100, 0x0105, "a"}, Range{0x0106, 0x010D, "c"}, Range{0x010E, 0x0111, "d"},
+    Range{0x0112, 0x011B, "e"}, Range{0x011C, 0x0123, "g"}, Range{0x0124, 0x0127, "h"},
+    Range{0x0128, 0x0131, "i"}, Range{0x0132, 0x0133, "ij"}, Range{0x0134, 0x0135, "j"},
+    Range{0x0136, 0x0138, "k"}, Range{0x0139, 0x0142, "l"}, Range{0x0143, 0x014B, "n"},
+    Range{0x014C, 0x0151, "o"}, Range{0x0152, 0x0153, "oe"}, Range{0x0154, 0x0159, "r"},
+    Range{0x015A, 0x0161, "s"}, Range{0x0162, 0x0167, "t"}, Range{0x0168, 0x0173, "u"},
+    Range{0x0174, 0x0175, "w"}, Range{0x0176, 0x0178, "y"}, Range{0x0179, 0x017E, "z"},
+    Range{0x017F, 0x017F, "s"},
+};
+
+// half width katakana U+FF66-U+FF9D to full width katakana.
+constexpr std::array<char16_t, 0xFF9D - 0xFF66 + 1> HALF_WIDTH_KATAKANA{
+    0x30F2, 0x30A1, 0x30A3, 0x30A5, 0x30A7, 0x30A9, 0x30E3, 0x30E5, 0x30E7, 0x30C3,
+    0x30FC, 0x30A2, 0x30A4, 0x30A6, 0x30A8, 0x30AA, 0x30AB, 0x30AD, 0x30AF, 0x30B1,
+    0x30B3, 0x30B5, 0x30B7, 0x30B9, 0x30BB, 0x30BD, 0x30BF, 0x30C1, 0x30C4, 0x30C6,
+    0x30C8, 0x30CA, 0x30CB, 0x30CC, 0x30CD, 0x30CE, 0x30CF, 0x30D2, 0x30D5, 0x30D8,
+    0x30DB, 0x30DE, 0x30DF, 0x30E0, 0x30E1, 0x30E2, 0x30E4, 0x30E6, 0x30E8, 0x30E9,
+    0x30EA, 0x30EB, 0x30EC, 0x30ED, 0x30EF, 0x30F3,
+};
+
+// decodes one code point, invalid bytes are taken as latin-1.
+auto next_code_point(std::string_view& str) -> char32_t {
+    const auto lead = static_cast<std::uint8_t>(str[0]);
+    std::size_t size = 1;
+    char32_t cp = lead;
+
+    if (lead >= 0xF0 && lead < 0xF8) {
+        size = 4;
+        cp = lead & 0x07;
+    } else if (lead >= 0xE0 && lead < 0xF0) {
+        size = 3;
+        cp = lead & 0x0F;
+    } else if (lead >= 0xC0 && lead < 0xE0) {
+        size = 2;
+        cp = lead & 0x1F;
+    }
+
+    if (size > str.size()) {
+        size = 1;
+        cp = lead;
+    }
+
+    for (std::size_t i = 1; i < size; i++) {
+        const auto byte = static_cast<std::uint8_t>(str[i]);
+        if ((byte & 0xC0) != 0x80) {
+            size = 1;
+            cp = lead;
+            break;
+        }
+        cp = (cp << 6) | (byte & 0x3F);
+    }
+
+    str.remove_prefix(size);
+    return cp;
+}
+
+void append_utf8(std::string& out, char32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// voiced and small hiragana to the plain kana they sort with.
+auto plain_hiragana(char32_t cp) -> char32_t {
+    switch (cp) {
+        // small vowels, っ, small ya / yu / yo / wa sit right before their plain kana
+        case 0x3041: case 0x3043: case 0x3045: case 0x3047: case 0x3049:
+        case 0x3063: case 0x3083: case 0x3085: case 0x3087: case 0x308E:
+            return cp + 1;
+        case 0x3095: return 0x304B; // small ka
+        case 0x3096: return 0x3051; // small ke
+        case 0x3094: return 0x3046; // vu
+        // ぢ / づ / で / ど come after っ / つ so they don't follow the pattern
+        case 0x3062: return 0x3061;
+        case 0x3065: return 0x3064;
+        case 0x3067: return 0x3066;
+        case 0x3069: return 0x3068;
+    }
+
+    // ka to to rows, voiced kana follow the plain one
+    if (cp >= 0x304C && cp <= 0x3060 && !(cp & 1)) {
+        return cp - 1;
+    }
+
+    // ha row, plain then voiced then semi voiced
+    if (cp >= 0x306F && cp <= 0x307D) {
+        return cp - (cp - 0x306F) % 3;
+    }
+
+    return cp;
+}
+
+auto fold(char32_t cp, std::string& out) -> void {
+    // full width ascii and the ideographic space
+    if (cp >= 0xFF01 && cp <= 0xFF5E) {
+        cp -= 0xFEE0;
+    } else if (cp == 0x3000) {
+        cp = ' ';
+    }
+
+    if (cp < 0x80) {
+        if (cp >= 'A' && cp <= 'Z') {
+            cp += 'a' - 'A';
+        }
+        out += static_cast<char>(cp);
+        return;
+    }
+
+    if (cp >= 0x00C0 && cp <= 0x017F) {
+        for (const auto& range : LATIN_RANGES) {
+            if (cp >= range.first && cp <= range.last) {
+                out += range.folded;
+                return;
+            }
+        }
+    }
+
+    // greek and cyrillic capitals
+    if ((cp >= 0x0391 && cp <= 0x03A9) || (cp >= 0x0410 && cp <= 0x042F)) {
+        cp += 0x20;
+    } else if (cp >= 0x0400 && cp <= 0x040F) {
+        cp += 0x50;
+    }
+
+    // half width kana voicing marks, the kana before already sorts as plain
+    if (cp == 0xFF9E || cp == 0xFF9F) {
+        return;
+    }
+
+    if (cp >= 0xFF66 && cp <= 0xFF9D) {
+        cp = HALF_WIDTH_KATAKANA[cp - 0xFF66];
+    }
+
+    // katakana to hiragana
+    if (cp >= 0x30A1 && cp <= 0x30F6) {
+        cp -= 0x60;
+    }
+
+    if (cp >= 0x3041 && cp <= 0x3096) {
+        cp = plain_hiragana(cp);
+    }
+
+    append_utf8(out, cp);
+}
+
+} // namespace
+
+std::string collation_key(std::string_view str) {
+    std::string key;
+    key.reserve(str.size());
+    while (!str.empty()) {
+        fold(next_code_point(str), key);
+    }
+    return key;
+}
+
+} // namespace util
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace util {
+
+// builds a key from a utf8 string such that comparing keys byte by byte
+// orders strings the way people expect, rather than by code point:
+// case, accents and full / half width forms are folded, katakana is folded
+// into hiragana, and voiced / small kana sort with their plain kana.
+// the key is utf8 as well, so it can be compared with memcmp.
+[[nodiscard]] std::string collation_key(std::string_view str);
+
+} // namespace util
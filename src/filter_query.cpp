@@ -0,0 +1,456 @@
+#include "filter_query.hpp"
+#include "collation.hpp"
+#include "string_format.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+namespace tj {
+namespace {
+
+struct Token {
+    enum class Kind { End, Word, Number, String, Symbol };
+    Kind kind;
+    std::string_view text;
+    std::size_t pos;
+};
+
+auto is_alpha(char c) -> bool {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+auto is_digit(char c) -> bool {
+    return c >= '0' && c <= '9';
+}
+
+auto equals_nocase(std::string_view a, std::string_view b) -> bool {
+    return std::ranges::equal(a, b, [](char x, char y) {
+        const auto lower = [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+        return lower(x) == lower(y);
+    });
+}
+
+// numbers keep their unit, eg 10h, so the parser can tell them apart.
+auto tokenize(std::string_view text) -> std::vector<Token> {
+    std::vector<Token> tokens;
+    std::size_t i = 0;
+
+    while (i < text.size()) {
+        const auto c = text[i];
+        const auto start = i;
+
+        if (c == ' ' || c == '\t') {
+            i++;
+            continue;
+        }
+
+        if (is_alpha(c)) {
+            while (i < text.size() && (is_alpha(text[i]) || is_digit(text[i]))) {
+                i++;
+            }
+            tokens.emplace_back(Token::Kind::Word, text.substr(start, i - start), start);
+        } else if (is_digit(c)) {
+            while (i < text.size() && (is_digit(text[i]) || text[i] == '.' || is_alpha(text[i]))) {
+                i++;
+            }
+            tokens.emplace_back(Token::Kind::Number, text.substr(start, i - start), start);
+        } else if (c == '"') {
+            // unterminated strings run to the end.
+            const auto end = text.find('"', start + 1);
+            const auto last = end == std::string_view::npos ? text.size() : end;
+            tokens.emplace_back(Token::Kind::String, text.substr(start + 1, last - start - 1), start);
+            i = end == std::string_view::npos ? text.size() : end + 1;
+        } else if ((c == '<' || c == '>' || c == '!' || c == '=') && i + 1 < text.size() && text[i + 1] == '=') {
+            tokens.emplace_back(Token::Kind::Symbol, text.substr(start, 2), start);
+            i += 2;
+        } else {
+            tokens.emplace_back(Token::Kind::Symbol, text.substr(start, 1), start);
+            i++;
+        }
+    }
+
+    tokens.emplace_back(Token::Kind::End, std::string_view{}, text.size());
+    return tokens;
+}
+
+// eg 10h, 90m, 1.5h or 2d. plain numbers are hours.
+auto parse_duration(std::string_view text) -> std::optional<std::uint64_t> {
+    double number{};
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (ec != std::errc{} || number < 0) {
+        return std::nullopt;
+    }
+
+    const std::string_view unit{ptr, text.data() + text.size()};
+    double scale{};
+    if (unit.empty() || equals_nocase(unit, "h")) {
+        scale = 60 * 60;
+    } else if (equals_nocase(unit, "s")) {
+        scale = 1;
+    } else if (equals_nocase(unit, "m") || equals_nocase(unit, "min")) {
+        scale = 60;
+    } else if (equals_nocase(unit, "d")) {
+        scale = 60 * 60 * 24;
+    } else {
+        return std::nullopt;
+    }
+
+    return static_cast<std::uint64_t>(std::llround(number * scale));
+}
+
+auto parse_count(std::string_view text) -> std::optional<std::uint64_t> {
+    std::uint64_t number{};
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (ec != std::errc{} || ptr != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return number;
+}
+
+// the comparison is picked once per column rather than per row, so the
+// loop stays a plain compare the compiler can vectorise.
+template<typename T, typename Cmp>
+void compare_column(std::span<const T> column, Cmp cmp, T value, std::span<std::uint8_t> out) {
+    const auto run = [&](auto pred) {
+        for (std::size_t i = 0; i < column.size(); i++) {
+            out[i] = pred(column[i]);
+        }
+    };
+
+    switch (cmp) {
+        case Cmp::Less: run([value](T x) { return x < value; }); break;
+        case Cmp::LessEqual: run([value](T x) { return x <= value; }); break;
+        case Cmp::Greater: run([value](T x) { return x > value; }); break;
+        case Cmp::GreaterEqual: run([value](T x) { return x >= value; }); break;
+        case Cmp::Equal: run([value](T x) { return x == value; }); break;
+        case Cmp::NotEqual: run([value](T x) { return x != value; }); break;
+        case Cmp::Contains: std::ranges::fill(out, 0); break;
+    }
+}
+
+template<typename Cmp>
+auto text_matches(std::string_view haystack, Cmp cmp, std::string_view needle) -> bool {
+    switch (cmp) {
+        case Cmp::Equal: return haystack == needle;
+        case Cmp::NotEqual: return haystack != needle;
+        case Cmp::Contains: return haystack.find(needle) != std::string_view::npos;
+        default: return false;
+    }
+}
+
+} // namespace
+
+// recursive descent, emitting steps in postfix order as it goes.
+//   or        := and ("or" and)*
+//   and       := unary ("and" unary)*
+//   unary     := "not" unary | "(" or ")" | predicate
+//   predicate := "playtime" cmp duration
+//              | ("name" | "author") ("=" | "!=" | "~") text
+//              | "played" "in" "last" count ["days"]
+//              | "installed" | "uninstalled"
+class FilterQuery::Parser final {
+public:
+    Parser(std::string_view text, std::vector<Step>& program)
+    : tokens{tokenize(text)}
+    , program{program} {}
+
+    bool Parse() {
+        if (this->Peek().kind == Token::Kind::End) {
+            return this->Fail("empty filter");
+        }
+
+        if (!this->ParseOr()) {
+            return false;
+        }
+
+        if (this->Peek().kind != Token::Kind::End) {
+            return this->Fail(string_format("unexpected '%.*s'", static_cast<int>(this->Peek().text.size()), this->Peek().text.data()));
+        }
+
+        return true;
+    }
+
+    std::string error{};
+
+private:
+    std::vector<Token> tokens;
+    std::vector<Step>& program;
+    std::size_t index{};
+
+    const Token& Peek() const {
+        return this->tokens[this->index];
+    }
+
+    const Token& Next() {
+        const auto& token = this->tokens[this->index];
+        if (token.kind != Token::Kind::End) {
+            this->index++;
+        }
+        return token;
+    }
+
+    bool AcceptWord(std::string_view word) {
+        if (this->Peek().kind == Token::Kind::Word && equals_nocase(this->Peek().text, word)) {
+            this->index++;
+            return true;
+        }
+        return false;
+    }
+
+    bool AcceptSymbol(std::string_view symbol) {
+        if (this->Peek().kind == Token::Kind::Symbol && this->Peek().text == symbol) {
+            this->index++;
+            return true;
+        }
+        return false;
+    }
+
+    bool Fail(std::string message) {
+        if (this->error.empty()) {
+            this->error = string_format("%s at %zu", message.c_str(), this->Peek().pos + 1);
+        }
+        return false;
+    }
+
+    void Emit(Op op, Cmp cmp = Cmp::Equal, std::uint64_t value = 0, std::string text = {}) {
+        this->program.emplace_back(op, cmp, value, std::move(text));
+    }
+
+    bool ParseOr() {
+        if (!this->ParseAnd()) {
+            return false;
+        }
+        while (this->AcceptWord("or") || this->AcceptSymbol("|")) {
+            if (!this->ParseAnd()) {
+                return false;
+            }
+            this->Emit(Op::Or);
+        }
+        return true;
+    }
+
+    bool ParseAnd() {
+        if (!this->ParseUnary()) {
+            return false;
+        }
+        while (this->AcceptWord("and") || this->AcceptSymbol("&")) {
+            if (!this->ParseUnary()) {
+                return false;
+            }
+            this->Emit(Op::And);
+        }
+        return true;
+    }
+
+    bool ParseUnary() {
+        if (this->AcceptWord("not") || this->AcceptSymbol("!")) {
+            if (!this->ParseUnary()) {
+                return false;
+            }
+            this->Emit(Op::Not);
+            return true;
+        }
+
+        if (this->AcceptSymbol("(")) {
+            if (!this->ParseOr()) {
+                return false;
+            }
+            return this->AcceptSymbol(")") || this->Fail("expected ')'");
+        }
+
+        return this->ParsePredicate();
+    }
+
+    std::optional<Cmp> ParseCmp(bool text) {
+        const auto& token = this->Peek();
+        if (token.kind != Token::Kind::Symbol) {
+            return std::nullopt;
+        }
+
+        const auto cmp = [&]() -> std::optional<Cmp> {
+            if (token.text == "=" || token.text == "==") {
+                return Cmp::Equal;
+            } else if (token.text == "!=") {
+                return Cmp::NotEqual;
+            } else if (token.text == "~") {
+                return text ? std::optional{Cmp::Contains} : std::nullopt;
+            } else if (text) {
+                return std::nullopt;
+            } else if (token.text == "<") {
+                return Cmp::Less;
+            } else if (token.text == "<=") {
+                return Cmp::LessEqual;
+            } else if (token.text == ">") {
+                return Cmp::Greater;
+            } else if (token.text == ">=") {
+                return Cmp::GreaterEqual;
+            }
+            return std::nullopt;
+        }();
+
+        if (cmp) {
+            this->index++;
+        }
+        return cmp;
+    }
+
+    bool ParsePredicate() {
+        const auto& token = this->Peek();
+        if (token.kind != Token::Kind::Word) {
+            return this->Fail("expected a field");
+        }
+        this->index++;
+
+        if (equals_nocase(token.text, "playtime")) {
+            const auto cmp = this->ParseCmp(false);
+            if (!cmp) {
+                return this->Fail("expected a comparison");
+            }
+            const auto& number = this->Peek();
+            const auto seconds = number.kind == Token::Kind::Number ? parse_duration(number.text) : std::nullopt;
+            if (!seconds) {
+                return this->Fail("expected a duration, eg 10h or 30m");
+            }
+            this->index++;
+            this->Emit(Op::Playtime, *cmp, *seconds);
+            return true;
+        }
+
+        if (equals_nocase(token.text, "name") || equals_nocase(token.text, "author")) {
+            const auto op = equals_nocase(token.text, "name") ? Op::Name : Op::Author;
+            const auto cmp = this->ParseCmp(true);
+            if (!cmp) {
+                return this->Fail("expected =, != or ~");
+            }
+            const auto& value = this->Next();
+            if (value.kind != Token::Kind::String && value.kind != Token::Kind::Word && value.kind != Token::Kind::Number) {
+                return this->Fail("expected text");
+            }
+            this->Emit(op, *cmp, 0, util::collation_key(value.text));
+            return true;
+        }
+
+        if (equals_nocase(token.text, "played")) {
+            if (!this->AcceptWord("in") || !this->AcceptWord("last")) {
+                return this->Fail("expected 'in last'");
+            }
+            const auto& number = this->Peek();
+            const auto days = number.kind == Token::Kind::Number ? parse_count(number.text) : std::nullopt;
+            if (!days || !*days) {
+                return this->Fail("expected a number of days");
+            }
+            this->index++;
+            if (!this->AcceptWord("days")) {
+                this->AcceptWord("day");
+            }
+            this->Emit(Op::PlayedSince, Cmp::GreaterEqual, *days);
+            return true;
+        }
+
+        if (equals_nocase(token.text, "installed")) {
+            this->Emit(Op::Installed);
+            return true;
+        }
+
+        if (equals_nocase(token.text, "uninstalled")) {
+            this->Emit(Op::Installed);
+            this->Emit(Op::Not);
+            return true;
+        }
+
+        this->index--;
+        return this->Fail(string_format("unknown field '%.*s'", static_cast<int>(token.text.size()), token.text.data()));
+    }
+};
+
+auto FilterQuery::Compile(std::string_view text, std::string& error) -> std::optional<FilterQuery> {
+    FilterQuery query;
+    Parser parser{text, query.program};
+    if (!parser.Parse()) {
+        error = std::move(parser.error);
+        return std::nullopt;
+    }
+
+    query.text = text;
+    return query;
+}
+
+auto FilterQuery::Evaluate(const FilterColumns& columns) const -> std::vector<std::uint8_t> {
+    const auto& titles = columns.titles;
+    const auto rows = titles.Size();
+    std::vector<std::vector<std::uint8_t>> stack;
+
+    for (const auto& step : this->program) {
+        if (step.op == Op::And || step.op == Op::Or) {
+            auto rhs = std::move(stack.back());
+            stack.pop_back();
+            auto& lhs = stack.back();
+            if (step.op == Op::And) {
+                for (std::size_t i = 0; i < rows; i++) {
+                    lhs[i] &= rhs[i];
+                }
+            } else {
+                for (std::size_t i = 0; i < rows; i++) {
+                    lhs[i] |= rhs[i];
+                }
+            }
+            continue;
+        }
+
+        if (step.op == Op::Not) {
+            for (auto& value : stack.back()) {
+                value ^= 1;
+            }
+            continue;
+        }
+
+        auto& out = stack.emplace_back(rows);
+        switch (step.op) {
+            case Op::Playtime:
+                compare_column(titles.SecondsColumn(), step.cmp, step.value, std::span{out});
+                break;
+
+            case Op::PlayedSince: {
+                // never played is 0, which is always before the first day.
+                const auto first_day = static_cast<std::uint32_t>(std::max<std::int64_t>(1, static_cast<std::int64_t>(columns.today) - static_cast<std::int64_t>(step.value) + 1));
+                if (columns.last_played.size() == rows) {
+                    compare_column(columns.last_played, step.cmp, first_day, std::span{out});
+                }
+            }   break;
+
+            case Op::Installed: {
+                const auto flags = titles.FlagsColumn();
+                for (std::size_t i = 0; i < rows; i++) {
+                    out[i] = (flags[i] & TitleTable::Flag_Installed) != 0;
+                }
+            }   break;
+
+            case Op::Name:
+                for (TitleTable::Row row = 0; row < rows; row++) {
+                    out[row] = text_matches(titles.NameKey(row), step.cmp, step.text);
+                }
+                break;
+
+            case Op::Author: {
+                // each distinct author is checked once, rows just look the result up.
+                std::vector<std::uint8_t> accepted(titles.AuthorCount());
+                for (std::uint32_t id = 0; id < accepted.size(); id++) {
+                    accepted[id] = text_matches(util::collation_key(titles.AuthorById(id)), step.cmp, step.text);
+                }
+                const auto ids = titles.AuthorIdColumn();
+                for (std::size_t i = 0; i < rows; i++) {
+                    out[i] = accepted[ids[i]];
+                }
+            }   break;
+
+            case Op::And: case Op::Or: case Op::Not:
+                break;
+        }
+    }
+
+    return std::move(stack.back());
+}
+
+} // namespace tj
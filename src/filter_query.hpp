@@ -0,0 +1,74 @@
+#pragma once
+
+#include "title_table.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tj {
+
+// the columns a filter can look at.
+struct FilterColumns {
+    const TitleTable& titles;
+    std::span<const std::uint32_t> last_played; // per row, day last played or 0 if never
+    std::uint32_t today;                        // days since the unix epoch
+};
+
+// a filter over the title table, eg
+//   playtime > 10h and author = "Nintendo"
+//   not installed or played in last 30 days
+//   name ~ "zelda"
+// compiled once into a postfix program where each step works on a whole
+// column at a time, producing a byte mask per row. text is folded with
+// util::collation_key() so comparisons don't care about case or accents,
+// and authors are matched once per distinct author rather than per row.
+class FilterQuery final {
+public:
+    // nullopt with the reason in error if the text doesn't parse.
+    [[nodiscard]] static std::optional<FilterQuery> Compile(std::string_view text, std::string& error);
+
+    // 1 for every row that passes, 0 otherwise.
+    [[nodiscard]] std::vector<std::uint8_t> Evaluate(const FilterColumns& columns) const;
+
+    [[nodiscard]] std::string_view Text() const { return this->text; }
+
+private:
+    enum class Op : std::uint8_t {
+        Playtime,       // seconds cmp value
+        PlayedSince,    // played within the last value days
+        Installed,
+        Name,           // folded name cmp text
+        Author,         // folded author cmp text
+        And,
+        Or,
+        Not,
+    };
+
+    enum class Cmp : std::uint8_t {
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Equal,
+        NotEqual,
+        Contains,
+    };
+
+    struct Step {
+        Op op;
+        Cmp cmp{Cmp::Equal};
+        std::uint64_t value{};
+        std::string text{};
+    };
+
+    class Parser;
+
+    std::vector<Step> program{};
+    std::string text{};
+};
+
+} // namespace tj
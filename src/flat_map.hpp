@@ -0,0 +1,103 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+// open addressing hash map for integer keys, with linear probing.
+// slots live in one array so lookups stay within a cache line or two,
+// unlike std::unordered_map which allocates a node per entry.
+// there is no erase, the maps this is used for only ever grow.
+template<typename Key, typename Value>
+requires std::is_integral_v<Key>
+class FlatMap final {
+public:
+    // returns the value and true if it was inserted, or the existing value.
+    std::pair<Value*, bool> try_emplace(Key key, Value value) {
+        if ((this->count + 1) * 4 > this->slots.size() * 3) {
+            this->grow();
+        }
+
+        auto& slot = this->probe(key);
+        if (slot.used) {
+            return {&slot.value, false};
+        }
+
+        slot = Slot{key, std::move(value), true};
+        this->count++;
+        return {&slot.value, true};
+    }
+
+    [[nodiscard]] Value* find(Key key) {
+        if (this->slots.empty()) {
+            return nullptr;
+        }
+        auto& slot = this->probe(key);
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    [[nodiscard]] const Value* find(Key key) const {
+        return const_cast<FlatMap*>(this)->find(key);
+    }
+
+    void reserve(std::size_t size) {
+        const auto capacity = std::bit_ceil(size * 4 / 3 + 1);
+        if (capacity > this->slots.size()) {
+            this->rehash(capacity);
+        }
+    }
+
+    void clear() {
+        this->slots.clear();
+        this->count = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->count; }
+    [[nodiscard]] bool empty() const noexcept { return this->count == 0; }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        bool used{false};
+    };
+
+    std::vector<Slot> slots{}; // size is 0 or a power of 2
+    std::size_t count{};
+
+    // fibonacci hashing spreads sequential keys, eg offsets, over the table.
+    [[nodiscard]] std::size_t index_of(Key key) const {
+        const auto hash = static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(hash >> 32) & (this->slots.size() - 1);
+    }
+
+    // the slot holding key, or the empty slot it would go in.
+    Slot& probe(Key key) {
+        for (auto i = this->index_of(key);; i = (i + 1) & (this->slots.size() - 1)) {
+            auto& slot = this->slots[i];
+            if (!slot.used || slot.key == key) {
+                return slot;
+            }
+        }
+    }
+
+    void grow() {
+        this->rehash(this->slots.empty() ? 16 : this->slots.size() * 2);
+    }
+
+    void rehash(std::size_t capacity) {
+        auto old = std::exchange(this->slots, std::vector<Slot>(capacity));
+        for (auto& slot : old) {
+            if (slot.used) {
+                this->probe(slot.key) = std::move(slot);
+            }
+        }
+    }
+};
+
+} // namespace util
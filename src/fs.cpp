@@ -0,0 +1,67 @@
+#include "fs.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace util {
+namespace {
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { std::fclose(f); }
+};
+
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+} // namespace
+
+bool read_file(const char* path, std::vector<std::uint8_t>& out) {
+    File f{std::fopen(path, "rb")};
+    if (!f) {
+        return false;
+    }
+
+    out.clear();
+    if (!std::fseek(f.get(), 0, SEEK_END)) {
+        if (const auto size = std::ftell(f.get()); size > 0) {
+            out.reserve(size);
+        }
+        std::rewind(f.get());
+    }
+
+    std::uint8_t buf[0x1000];
+    std::size_t read;
+    while ((read = std::fread(buf, 1, sizeof(buf), f.get())) > 0) {
+        out.insert(out.end(), buf, buf + read);
+    }
+    return !std::ferror(f.get());
+}
+
+bool write_file(const char* path, std::span<const std::uint8_t> data) {
+    // so a crash can't leave a half written file behind.
+    const auto temp = std::string{path} + ".tmp";
+    {
+        File f{std::fopen(temp.c_str(), "wb")};
+        if (!f || std::fwrite(data.data(), 1, data.size(), f.get()) != data.size()) {
+            return false;
+        }
+        if (std::fclose(f.release())) {
+            return false;
+        }
+    }
+
+    // rename doesn't replace existing files on the sd card.
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::filesystem::rename(temp, path, ec);
+    return !ec;
+}
+
+bool create_directories(const char* path) {
+    std::error_code ec;
+    std::filesystem::create_directories(path, ec);
+    return !ec;
+}
+
+} // namespace util
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace tj {
+
+// where caches are kept on the sd card.
+inline constexpr auto CONFIG_PATH = "sdmc:/config/PlaytimeNX";
+
+} // namespace tj
+
+namespace util {
+
+// reads the whole file, false if it can't be opened.
+[[nodiscard]] bool read_file(const char* path, std::vector<std::uint8_t>& out);
+// writes to a temp file first, then replaces path with it.
+bool write_file(const char* path, std::span<const std::uint8_t> data);
+// creates the directory and its parents, fine if it already exists.
+bool create_directories(const char* path);
+
+} // namespace util
@@ -0,0 +1,105 @@
+#include "heatmap.hpp"
+#include "nvg_util.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace tj {
+namespace {
+
+using Rgba = std::array<std::uint8_t, 4>;
+
+// no play, then 4 steps relative to the best day of the year.
+constexpr std::array<Rgba, 5> LEVELS{{
+    {40, 40, 40, 255},
+    {0, 68, 58, 255},
+    {0, 122, 104, 255},
+    {0, 184, 157, 255},
+    {0, 255, 217, 255},
+}};
+
+} // namespace
+
+void Heatmap::Update(NVGcontext* vg, const PlayHistory& history, std::uint64_t id, int year) {
+    if (this->image && this->history == &history && this->rows == history.RowCount() && this->id == id && this->year == year) {
+        return;
+    }
+
+    this->history = &history;
+    this->rows = history.RowCount();
+    this->id = id;
+    this->year = year;
+    this->Build(history);
+
+    if (!this->image) {
+        this->image = nvgCreateImageRGBA(vg, WEEKS, WEEKDAYS, NVG_IMAGE_NEAREST, this->pixels.data());
+    } else {
+        nvgUpdateImage(vg, this->image, this->pixels.data());
+    }
+}
+
+void Heatmap::Build(const PlayHistory& history) {
+    using namespace std::chrono;
+    const auto first = sys_days{std::chrono::year{this->year} / January / 1};
+    const auto last = sys_days{std::chrono::year{this->year} / December / 31};
+    const auto first_day = static_cast<std::uint32_t>(first.time_since_epoch().count());
+    const auto day_count = static_cast<std::uint32_t>((last - first).count() + 1);
+    // weeks start on monday
+    const auto offset = (weekday{first}.iso_encoding() - 1);
+
+    std::array<std::uint32_t, 366> seconds{};
+    if (this->id == ALL_TITLES) {
+        for (std::uint32_t i = 0; i < day_count; i++) {
+            seconds[i] = static_cast<std::uint32_t>(history.Total(first_day + i, first_day + i));
+        }
+    } else if (const auto title = history.Find(this->id); title >= 0) {
+        const auto days = history.Days(title);
+        const auto values = history.Seconds(title);
+        auto row = std::ranges::lower_bound(days, first_day) - days.begin();
+        for (; row < static_cast<std::ptrdiff_t>(days.size()) && days[row] < first_day + day_count; row++) {
+            seconds[days[row] - first_day] = values[row];
+        }
+    }
+
+    this->total = 0;
+    this->best = 0;
+    this->days_played = 0;
+    for (std::uint32_t i = 0; i < day_count; i++) {
+        this->total += seconds[i];
+        this->best = std::max(this->best, seconds[i]);
+        this->days_played += seconds[i] != 0;
+    }
+
+    this->pixels.fill(0);
+    for (std::uint32_t i = 0; i < day_count; i++) {
+        const auto cell = i + offset;
+        const auto x = cell / WEEKDAYS;
+        const auto y = cell % WEEKDAYS;
+
+        std::size_t level = 0;
+        if (seconds[i]) {
+            level = 1 + std::min<std::size_t>(3, seconds[i] * 4 / (this->best + 1));
+        }
+
+        std::ranges::copy(LEVELS[level], this->pixels.begin() + (y * WEEKS + x) * 4);
+    }
+}
+
+void Heatmap::Draw(NVGcontext* vg, float x, float y, float cell_size) const {
+    if (!this->image) {
+        return;
+    }
+
+    const auto w = WEEKS * cell_size;
+    const auto h = WEEKDAYS * cell_size;
+    gfx::drawRect(vg, x, y, w, h, nvgImagePattern(vg, x, y, w, h, 0.f, this->image, 1.f));
+}
+
+void Heatmap::Destroy(NVGcontext* vg) {
+    if (this->image) {
+        nvgDeleteImage(vg, this->image);
+        this->image = 0;
+    }
+}
+
+} // namespace tj
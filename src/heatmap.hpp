@@ -0,0 +1,47 @@
+#pragma once
+
+#include "nanovg/nanovg.h"
+#include "play_history.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace tj {
+
+// a year of daily playtime, github contribution graph style.
+// each day is one texel of a tiny texture, columns are weeks and rows are
+// weekdays, so the whole calendar is a single nearest filtered rect.
+// the texture is only rewritten when the title / year / data changes.
+class Heatmap final {
+public:
+    static constexpr int WEEKS{54};
+    static constexpr int WEEKDAYS{7};
+    static constexpr std::uint64_t ALL_TITLES{0};
+
+    // call once per frame before Draw().
+    void Update(NVGcontext* vg, const PlayHistory& history, std::uint64_t id, int year);
+    void Draw(NVGcontext* vg, float x, float y, float cell_size) const;
+    void Destroy(NVGcontext* vg);
+
+    [[nodiscard]] std::uint64_t TotalSeconds() const { return this->total; }
+    [[nodiscard]] std::uint32_t BestDaySeconds() const { return this->best; }
+    [[nodiscard]] int DaysPlayed() const { return this->days_played; }
+
+private:
+    void Build(const PlayHistory& history);
+
+    int image{};
+    std::array<std::uint8_t, WEEKS * WEEKDAYS * 4> pixels{};
+
+    // what the texture currently shows
+    const PlayHistory* history{nullptr};
+    std::size_t rows{};
+    std::uint64_t id{};
+    int year{};
+
+    std::uint64_t total{};
+    std::uint32_t best{};
+    int days_played{};
+};
+
+} // namespace tj
@@ -0,0 +1,100 @@
+#include "init_graph.hpp"
+
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <cassert>
+#include <cstdio>
+
+namespace tj {
+
+InitGraph::Id InitGraph::Add(const char* name, Where where, std::initializer_list<Id> deps, util::Job&& fn) {
+    for ([[maybe_unused]] const auto dep : deps) {
+        assert(dep < this->nodes.size() && "dependencies must be added first");
+    }
+
+    this->nodes.emplace_back(Node{name, where, deps, {}, std::move(fn), 0, 0});
+    return this->nodes.size() - 1;
+}
+
+void InitGraph::Run() {
+    if (this->nodes.empty()) {
+        return;
+    }
+
+    for (auto& node : this->nodes) {
+        node.dependents.clear();
+    }
+    for (Id i = 0; i < this->nodes.size(); i++) {
+        for (const auto dep : this->nodes[i].deps) {
+            this->nodes[dep].dependents.emplace_back(i);
+        }
+    }
+
+    const auto start = util::instrument::now();
+    auto remaining = std::make_unique<std::atomic<std::size_t>[]>(this->nodes.size());
+    std::atomic<std::size_t> finished{0};
+    util::Dispatcher main_thread;
+    util::AsyncPromise<void> all_done;
+    auto done = all_done.get_future();
+
+    for (Id i = 0; i < this->nodes.size(); i++) {
+        remaining[i].store(this->nodes[i].deps.size(), std::memory_order_relaxed);
+    }
+
+    std::function<void(Id)> schedule;
+    const auto run_node = [&](Id id) {
+        auto& node = this->nodes[id];
+        node.start = util::instrument::now() - start;
+        node.fn();
+        node.end = util::instrument::now() - start;
+
+        for (const auto dependent : node.dependents) {
+            if (remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                schedule(dependent);
+            }
+        }
+
+        // Run() may return as soon as the last node is counted, so nothing
+        // it owns can be touched after counting, unless this is the last.
+        const auto count = this->nodes.size();
+        auto& promise = all_done;
+        if (finished.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            promise.set_value();
+        }
+    };
+
+    schedule = [&](Id id) {
+        if (this->nodes[id].where == Where::Worker) {
+            util::ThreadPool::get_default().post([&run_node, id]{ run_node(id); }, util::Priority::High);
+        } else {
+            main_thread.post([&run_node, id]{ run_node(id); }, util::Priority::High);
+        }
+    };
+
+    for (Id i = 0; i < this->nodes.size(); i++) {
+        if (this->nodes[i].deps.empty()) {
+            schedule(i);
+        }
+    }
+
+    main_thread.run_until_ready(done);
+    done.get();
+    this->total = util::instrument::now() - start;
+}
+
+void InitGraph::LogReport() const {
+#ifndef NDEBUG
+    const auto ms = [](util::instrument::Nanoseconds ns) {
+        return static_cast<double>(ns) / 1e6;
+    };
+
+    for (const auto& node : this->nodes) {
+        std::printf("[startup] %-20s %-6s at %7.2fms took %7.2fms\n",
+            node.name, node.where == Where::Main ? "main" : "worker", ms(node.start), ms(node.end - node.start));
+    }
+    std::printf("[startup] total %.2fms\n", ms(this->total));
+#endif // NDEBUG
+}
+
+} // namespace tj
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "async.hpp"
+#include "instrumentation.hpp"
+
+#include <cstddef>
+#include <vector>
+#include <initializer_list>
+
+namespace tj {
+
+// startup work as a dependency graph.
+// worker nodes run on the thread pool, main nodes on the thread calling Run(),
+// each node starts as soon as everything it depends on has finished.
+class InitGraph final {
+public:
+    using Id = std::size_t;
+
+    enum class Where {
+        Main,   // anything touching deko3d / nanovg
+        Worker,
+    };
+
+    Id Add(const char* name, Where where, std::initializer_list<Id> deps, util::Job&& fn);
+
+    // blocks until every node has ran.
+    void Run();
+
+    // logs when each node ran and for how long, only in debug builds.
+    void LogReport() const;
+
+private:
+    struct Node {
+        const char* name;
+        Where where;
+        std::vector<Id> deps;
+        std::vector<Id> dependents;
+        util::Job fn;
+        util::instrument::Nanoseconds start;
+        util::instrument::Nanoseconds end;
+    };
+
+    std::vector<Node> nodes{};
+    util::instrument::Nanoseconds total{};
+};
+
+} // namespace tj
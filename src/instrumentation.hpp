@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#ifdef __SWITCH__
+    #include <switch.h>
+#endif // __SWITCH__
+
+// lightweight counters and timers, readable from any thread.
+// everything registered in the Registry can be sampled for benchmarking.
+namespace util::instrument {
+
+using Nanoseconds = std::uint64_t;
+
+// monotonic time.
+inline Nanoseconds now() noexcept {
+#ifdef __SWITCH__
+    return armTicksToNs(armGetSystemTick());
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif // __SWITCH__
+}
+
+class Counter final {
+public:
+    void add(std::uint64_t n = 1) noexcept {
+        this->value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void store(std::uint64_t n) noexcept {
+        this->value.store(n, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]]
+    auto load() const noexcept {
+        return this->value.load(std::memory_order_relaxed);
+    }
+
+    void reset() noexcept {
+        this->store(0);
+    }
+
+private:
+    std::atomic<std::uint64_t> value{0};
+};
+
+class Stopwatch final {
+public:
+    void reset() noexcept {
+        this->start = now();
+    }
+
+    [[nodiscard]]
+    auto elapsed() const noexcept -> Nanoseconds {
+        return now() - this->start;
+    }
+
+private:
+    Nanoseconds start{now()};
+};
+
+struct Sample {
+    const char* name;
+    std::uint64_t value;
+};
+
+class Registry final {
+public:
+    static Registry& get() {
+        static Registry registry;
+        return registry;
+    }
+
+    // the counter must be removed before it's destroyed.
+    void add(const char* name, const Counter& counter) {
+        std::scoped_lock lock{this->mutex};
+        this->counters.emplace_back(name, &counter);
+    }
+
+    void remove(const Counter& counter) {
+        std::scoped_lock lock{this->mutex};
+        std::erase_if(this->counters, [&counter](const auto& entry){ return entry.second == &counter; });
+    }
+
+    [[nodiscard]]
+    auto sample() const -> std::vector<Sample> {
+        std::scoped_lock lock{this->mutex};
+        std::vector<Sample> samples;
+        samples.reserve(this->counters.size());
+        for (const auto& [name, counter] : this->counters) {
+            samples.emplace_back(name, counter->load());
+        }
+        return samples;
+    }
+
+    // prints every counter, only in debug builds.
+    void log() const {
+#ifndef NDEBUG
+        for (const auto& [name, value] : this->sample()) {
+            std::printf("[instrument] %s: %lu\n", name, static_cast<unsigned long>(value));
+        }
+#endif // NDEBUG
+    }
+
+private:
+    mutable std::mutex mutex{};
+    std::vector<std::pair<const char*, const Counter*>> counters{}; // mutex locked
+};
+
+} // namespace util::instrument
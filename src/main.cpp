@@ -37,8 +37,9 @@ void userAppExit(void) {
 
 int main(int argc, char** argv) {
     tj::App app{};
-    app.RequestAccountUid();
+    // metadata doesn't depend on the user, so start scanning while they pick.
     app.SpawnScanThread();
+    app.RequestAccountUid();
     app.Loop();
     return 0;
 }
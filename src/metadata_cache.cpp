@@ -0,0 +1,146 @@
+#include "metadata_cache.hpp"
+#include "byte_io.hpp"
+#include "fs.hpp"
+#include "string_format.hpp"
+
+#include <algorithm>
+
+namespace tj {
+namespace {
+
+constexpr std::uint32_t MAGIC = 0x444D5450; // "PTMD"
+constexpr std::uint32_t VERSION = 2;
+
+auto metadata_path() -> std::string {
+    return string_format("%s/metadata.bin", CONFIG_PATH);
+}
+
+auto icon_dir() -> std::string {
+    return string_format("%s/icons", CONFIG_PATH);
+}
+
+auto icon_path(std::uint64_t id) -> std::string {
+    return string_format("%s/icons/%016lX.jpg", CONFIG_PATH, id);
+}
+
+} // namespace
+
+bool MetadataCache::Load() {
+    std::vector<std::uint8_t> data;
+    if (!util::read_file(metadata_path().c_str(), data)) {
+        return false;
+    }
+
+    util::ByteReader reader{data};
+    std::uint32_t magic{}, version{};
+    if (!reader.get(magic) || !reader.get(version) || magic != MAGIC || version != VERSION) {
+        return false;
+    }
+
+    util::StringArena strings;
+    std::uint64_t count{};
+    if (!strings.deserialize(reader) || !reader.get_varint(count)) {
+        return false;
+    }
+
+    const auto get_ref = [&](util::StringArena::Ref& ref) {
+        std::uint64_t offset{}, size{};
+        if (!reader.get_varint(offset) || !reader.get_varint(size) || offset + size > strings.stored_bytes()) {
+            return false;
+        }
+        ref = {static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(size)};
+        return true;
+    };
+
+    decltype(this->entries) entries;
+    entries.reserve(std::min<std::uint64_t>(count, reader.remaining()));
+    for (std::uint64_t i = 0; i < count; i++) {
+        std::uint64_t id{};
+        std::uint8_t has_icon{};
+        Entry entry{};
+        if (!reader.get(id) || !get_ref(entry.name) || !get_ref(entry.author) || !get_ref(entry.display_version) || !reader.get(has_icon)) {
+            return false;
+        }
+        entry.has_icon = has_icon;
+        entries.emplace(id, entry);
+    }
+
+    this->entries = std::move(entries);
+    this->strings = std::move(strings);
+    this->dirty = false;
+    return true;
+}
+
+bool MetadataCache::Save() {
+    if (!this->dirty) {
+        return true;
+    }
+
+    util::create_directories(CONFIG_PATH);
+
+    std::vector<std::uint8_t> data;
+    util::ByteWriter writer{data};
+    writer.put(MAGIC);
+    writer.put(VERSION);
+    this->strings.serialize(writer);
+
+    const auto put_ref = [&](util::StringArena::Ref ref) {
+        writer.put_varint(ref.offset);
+        writer.put_varint(ref.size);
+    };
+
+    writer.put_varint(this->entries.size());
+    for (const auto& [id, entry] : this->entries) {
+        writer.put(id);
+        put_ref(entry.name);
+        put_ref(entry.author);
+        put_ref(entry.display_version);
+        writer.put(static_cast<std::uint8_t>(entry.has_icon));
+    }
+
+    if (!util::write_file(metadata_path().c_str(), data)) {
+        return false;
+    }
+
+    this->dirty = false;
+    return true;
+}
+
+const MetadataCache::Entry* MetadataCache::Find(std::uint64_t id) const {
+    if (const auto it = this->entries.find(id); it != this->entries.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+void MetadataCache::Store(std::uint64_t id, std::string_view name, std::string_view author, std::string_view display_version, std::span<const std::uint8_t> icon) {
+    const auto it = this->entries.find(id);
+    const auto changed = it == this->entries.end() ||
+        this->Text(it->second.name) != name || this->Text(it->second.author) != author || this->Text(it->second.display_version) != display_version;
+    auto has_icon = it != this->entries.end() && it->second.has_icon;
+
+    // titles get updated, but icons practically never change.
+    if (!has_icon && !icon.empty()) {
+        util::create_directories(icon_dir().c_str());
+        has_icon = util::write_file(icon_path(id).c_str(), icon);
+    }
+
+    if (!changed && has_icon == it->second.has_icon) {
+        return;
+    }
+
+    this->entries.insert_or_assign(id, Entry{
+        this->strings.intern(name),
+        this->strings.intern(author),
+        this->strings.intern(display_version),
+        has_icon,
+    });
+    this->dirty = true;
+}
+
+bool MetadataCache::LoadIcon(std::uint64_t id, std::vector<std::uint8_t>& out) const {
+    const auto entry = this->Find(id);
+    return entry && entry->has_icon && util::read_file(icon_path(id).c_str(), out);
+}
+
+} // namespace tj
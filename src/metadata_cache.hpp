@@ -0,0 +1,43 @@
+#pragma once
+
+#include "string_arena.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tj {
+
+// name, author and icon of every title that was seen installed, so that
+// titles which have since been deleted can still be shown.
+// icons are kept as the original jpeg, one file per title, text is kept in
+// an arena which is written to the file as is.
+class MetadataCache final {
+public:
+    struct Entry {
+        util::StringArena::Ref name;
+        util::StringArena::Ref author;
+        util::StringArena::Ref display_version;
+        bool has_icon;
+    };
+
+    bool Load();
+    // only writes the file if something changed since Load().
+    bool Save();
+
+    [[nodiscard]] const Entry* Find(std::uint64_t id) const;
+    // the icon is written only if the title didn't have one cached yet.
+    void Store(std::uint64_t id, std::string_view name, std::string_view author, std::string_view display_version, std::span<const std::uint8_t> icon);
+    [[nodiscard]] std::string_view Text(util::StringArena::Ref ref) const { return this->strings.view(ref); }
+    [[nodiscard]] bool LoadIcon(std::uint64_t id, std::vector<std::uint8_t>& out) const;
+
+private:
+    std::unordered_map<std::uint64_t, Entry> entries{};
+    util::StringArena strings{};
+    bool dirty{false};
+};
+
+} // namespace tj
@@ -1,5 +1,6 @@
 #include "nvg_util.hpp"
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <array>
 #include <utility>
@@ -85,6 +86,25 @@ NVGcolor getColour(Colour c) {
     return map.at(c);
 }
 
+int createImageRaw(NVGcontext* vg, const unsigned char* blob, std::size_t size, int flags) {
+    if (size < 8) {
+        return 0;
+    }
+
+    // u32 width, u32 height, little endian
+    const auto read_u32 = [blob](std::size_t off) -> std::uint32_t {
+        return blob[off] | (blob[off + 1] << 8) | (blob[off + 2] << 16) | (std::uint32_t{blob[off + 3]} << 24);
+    };
+    const auto w = read_u32(0);
+    const auto h = read_u32(4);
+
+    if (!w || !h || w > 0x4000 || h > 0x4000 || size - 8 < std::size_t{w} * h * 4) {
+        return 0;
+    }
+
+    return nvgCreateImageRGBA(vg, static_cast<int>(w), static_cast<int>(h), flags, blob + 8);
+}
+
 void drawRect(NVGcontext* vg, float x, float y, float w, float h, Colour c) {
     nvgBeginPath(vg);
     nvgRect(vg, x, y, w, h);
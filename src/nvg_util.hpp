@@ -4,6 +4,7 @@
 #include <cstdarg>
 #include <array>
 #include <cstdio>
+#include <cstddef>
 
 namespace tj::gfx {
 
@@ -58,6 +59,10 @@ enum class Button {
 
 NVGcolor getColour(Colour c);
 
+// creates an image from a blob made by tools/img2rgba.c, no decoding needed.
+// returns 0 on failure, same as the nvgCreateImage functions.
+int createImageRaw(NVGcontext*, const unsigned char* blob, std::size_t size, int flags);
+
 void drawRect(NVGcontext*, float x, float y, float w, float h, Colour c);
 void drawRect(NVGcontext*, float x, float y, float w, float h, const NVGcolor& c);
 void drawRect(NVGcontext*, float x, float y, float w, float h, const NVGcolor&& c);
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "async.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+// below this many items the parallel helpers stay on the calling thread,
+// splitting the work costs more than it saves.
+inline constexpr std::size_t PARALLEL_MIN{1 << 14};
+
+// calls fn(i) for every i in [0, count), spread over the pool.
+// the calling thread takes part and runs whatever the workers haven't
+// picked up yet, so this is safe to call from a worker of the same pool.
+template<typename Fn>
+void parallel_for(ThreadPool& pool, std::size_t count, Fn&& fn, Priority priority = Priority::High) {
+    struct State {
+        std::atomic<std::size_t> next{0};
+        std::mutex mutex{};
+        std::condition_variable cv{};
+        std::size_t done{0}; // mutex locked
+    };
+
+    if (count <= 1) {
+        if (count) {
+            fn(std::size_t{0});
+        }
+        return;
+    }
+
+    auto state = std::make_shared<State>();
+    // fn is only touched while an index is claimed, and the caller doesn't
+    // return until every index is done, so it can be taken by reference.
+    const auto run = [count, &fn](State& state) {
+        std::size_t ran{};
+        for (auto i = state.next.fetch_add(1, std::memory_order_relaxed); i < count; i = state.next.fetch_add(1, std::memory_order_relaxed)) {
+            fn(i);
+            ran++;
+        }
+
+        if (ran) {
+            std::scoped_lock lock{state.mutex};
+            state.done += ran;
+            if (state.done == count) {
+                state.cv.notify_all();
+            }
+        }
+    };
+
+    const auto helpers = std::min(pool.size(), count - 1);
+    for (std::size_t i = 0; i < helpers; i++) {
+        pool.post([state, run]{ run(*state); }, priority);
+    }
+
+    run(*state);
+    std::unique_lock lock{state->mutex};
+    state->cv.wait(lock, [&]{ return state->done == count; });
+}
+
+namespace detail {
+
+// how many of the first n items of a stable merge of a and b come from a.
+template<typename T, typename Compare>
+auto merge_co_rank(std::size_t n, std::span<T> a, std::span<T> b, Compare& comp) -> std::size_t {
+    auto lo = n > b.size() ? n - b.size() : 0;
+    auto hi = std::min(n, a.size());
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2;
+        // a[mid] is in the first n if fewer than n - mid items of b sort before it,
+        // equal items of a go first to keep the merge stable.
+        if (n - mid - 1 >= b.size() || !comp(b[n - mid - 1], a[mid])) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// merges the part-th of parts equal slices of the output.
+template<typename T, typename Compare>
+void merge_part(std::span<T> a, std::span<T> b, std::span<T> out, std::size_t part, std::size_t parts, Compare& comp) {
+    const auto first = out.size() * part / parts;
+    const auto last = out.size() * (part + 1) / parts;
+    const auto a_first = merge_co_rank(first, a, b, comp);
+    const auto a_last = merge_co_rank(last, a, b, comp);
+
+    std::merge(
+        std::make_move_iterator(a.begin() + a_first), std::make_move_iterator(a.begin() + a_last),
+        std::make_move_iterator(b.begin() + (first - a_first)), std::make_move_iterator(b.begin() + (last - a_last)),
+        out.begin() + first, comp);
+}
+
+} // namespace detail
+
+// sorts chunks of items on the pool, then merges neighbouring runs until
+// one is left. merges are split along their output with a binary search
+// so that the last rounds, which only have one or two merges, still keep
+// every thread busy.
+template<typename T, typename Compare = std::less<>>
+void parallel_sort(ThreadPool& pool, std::span<T> items, Compare comp = {}) {
+    if (items.size() < PARALLEL_MIN || pool.size() == 0) {
+        std::sort(items.begin(), items.end(), comp);
+        return;
+    }
+
+    const auto chunks = pool.size() + 1;
+    std::vector<std::size_t> runs(chunks + 1);
+    for (std::size_t i = 0; i <= chunks; i++) {
+        runs[i] = items.size() * i / chunks;
+    }
+
+    parallel_for(pool, chunks, [&](std::size_t i) {
+        std::sort(items.begin() + runs[i], items.begin() + runs[i + 1], comp);
+    });
+
+    std::vector<T> buffer(items.size());
+    std::span<T> from{items};
+    std::span<T> to{buffer};
+
+    while (runs.size() > 2) {
+        const auto pairs = (runs.size() - 1) / 2;
+        const auto leftover = (runs.size() - 1) % 2;
+        const auto parts = (chunks + pairs - 1) / pairs;
+
+        parallel_for(pool, pairs * parts + leftover, [&](std::size_t task) {
+            // an odd run out has nothing to merge with this round.
+            if (task == pairs * parts) {
+                const auto first = runs[runs.size() - 2];
+                std::move(from.begin() + first, from.end(), to.begin() + first);
+                return;
+            }
+
+            const auto first = runs[task / parts * 2];
+            const auto middle = runs[task / parts * 2 + 1];
+            const auto last = runs[task / parts * 2 + 2];
+            detail::merge_part(from.subspan(first, middle - first), from.subspan(middle, last - middle), to.subspan(first, last - first), task % parts, parts, comp);
+        });
+
+        std::vector<std::size_t> merged;
+        for (std::size_t i = 0; i < runs.size(); i += 2) {
+            merged.emplace_back(runs[i]);
+        }
+        if (merged.back() != runs.back()) {
+            merged.emplace_back(runs.back());
+        }
+
+        runs = std::move(merged);
+        std::swap(from, to);
+    }
+
+    if (from.data() != items.data()) {
+        std::move(from.begin(), from.end(), items.begin());
+    }
+}
+
+// every index in [0, count) that pred accepts, in order.
+// each chunk counts its matches first so that it knows where to write
+// them, so pred is called twice per index and should be cheap.
+template<typename Index, typename Pred>
+auto parallel_filter(ThreadPool& pool, std::size_t count, Pred&& pred) -> std::vector<Index> {
+    std::vector<Index> out;
+
+    if (count < PARALLEL_MIN || pool.size() == 0) {
+        out.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            if (pred(i)) {
+                out.emplace_back(static_cast<Index>(i));
+            }
+        }
+        return out;
+    }
+
+    const auto chunks = pool.size() + 1;
+    std::vector<std::size_t> offsets(chunks + 1);
+    const auto bounds = [count, chunks](std::size_t chunk) {
+        return std::pair{count * chunk / chunks, count * (chunk + 1) / chunks};
+    };
+
+    parallel_for(pool, chunks, [&](std::size_t chunk) {
+        const auto [first, last] = bounds(chunk);
+        std::size_t matches{};
+        for (auto i = first; i < last; i++) {
+            matches += pred(i) ? 1 : 0;
+        }
+        offsets[chunk + 1] = matches;
+    });
+
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    out.resize(offsets.back());
+
+    parallel_for(pool, chunks, [&](std::size_t chunk) {
+        const auto [first, last] = bounds(chunk);
+        auto offset = offsets[chunk];
+        for (auto i = first; i < last; i++) {
+            if (pred(i)) {
+                out[offset++] = static_cast<Index>(i);
+            }
+        }
+    });
+
+    return out;
+}
+
+} // namespace util
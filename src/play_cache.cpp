@@ -0,0 +1,67 @@
+#include "play_cache.hpp"
+#include "byte_io.hpp"
+#include "fs.hpp"
+#include "string_format.hpp"
+
+#include <vector>
+
+namespace tj {
+namespace {
+
+constexpr std::uint32_t MAGIC = 0x43505450; // "PTPC"
+constexpr std::uint32_t VERSION = 3;
+
+} // namespace
+
+PlayCache::PlayCache(AccountUid uid)
+: uid{uid}
+, path{string_format("%s/play_events_%016lX%016lX.bin", CONFIG_PATH, uid.uid[0], uid.uid[1])} {
+}
+
+bool PlayCache::Load(PlaytimeEngine& engine, PlayCursor& cursor) const {
+    std::vector<std::uint8_t> data;
+    if (!util::read_file(this->path.c_str(), data)) {
+        return false;
+    }
+
+    util::ByteReader reader{data};
+    std::uint32_t magic{}, version{};
+    AccountUid uid{};
+    if (!reader.get(magic) || !reader.get(version) || magic != MAGIC || version != VERSION) {
+        return false;
+    }
+
+    if (!reader.get(uid) || uid.uid[0] != this->uid.uid[0] || uid.uid[1] != this->uid.uid[1]) {
+        return false;
+    }
+
+    PlayCursor c{};
+    if (!reader.get(c.next_index) || !reader.get(c.last_clock) || !reader.get(c.last_steady)) {
+        return false;
+    }
+
+    if (!engine.Deserialize(reader.rest())) {
+        return false;
+    }
+
+    cursor = c;
+    return true;
+}
+
+bool PlayCache::Save(const PlaytimeEngine& engine, const PlayCursor& cursor) const {
+    util::create_directories(CONFIG_PATH);
+
+    std::vector<std::uint8_t> data;
+    util::ByteWriter writer{data};
+    writer.put(MAGIC);
+    writer.put(VERSION);
+    writer.put(this->uid);
+    writer.put(cursor.next_index);
+    writer.put(cursor.last_clock);
+    writer.put(cursor.last_steady);
+    engine.Serialize(data);
+
+    return util::write_file(this->path.c_str(), data);
+}
+
+} // namespace tj
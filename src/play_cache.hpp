@@ -0,0 +1,27 @@
+#pragma once
+
+#include "play_events.hpp"
+
+#include <switch.h>
+#include <string>
+
+namespace tj {
+
+// folded play event log of one user, kept on the sd card so that each
+// launch only has to read the events logged since the last one.
+class PlayCache final {
+public:
+    explicit PlayCache(AccountUid uid);
+
+    // false if there's no cache, or it's from another version / user.
+    [[nodiscard]] bool Load(PlaytimeEngine& engine, PlayCursor& cursor) const;
+    bool Save(const PlaytimeEngine& engine, const PlayCursor& cursor) const;
+
+    [[nodiscard]] const std::string& Path() const { return this->path; }
+
+private:
+    AccountUid uid;
+    std::string path;
+};
+
+} // namespace tj
@@ -0,0 +1,294 @@
+#include "play_events.hpp"
+#include "byte_io.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace tj {
+namespace {
+
+auto join_u32(const u32 (&v)[2]) -> std::uint64_t {
+    return (static_cast<std::uint64_t>(v[0]) << 32) | v[1];
+}
+
+auto same_uid(const AccountUid& a, const AccountUid& b) -> bool {
+    return a.uid[0] == b.uid[0] && a.uid[1] == b.uid[1];
+}
+
+// converts a batch of raw events, drops those we don't care about.
+void ConvertPlayEvents(std::span<const PdmPlayEvent> in, std::vector<PlayEvent>& out) {
+    out.clear();
+
+    for (const auto& raw : in) {
+        PlayEvent e{};
+        e.clock = raw.timestamp_user;
+        e.steady = raw.timestamp_steady;
+
+        switch (raw.play_event_type) {
+            case PdmPlayEventType_Applet: {
+                const auto& applet = raw.event_data.applet;
+                // titles that opted out of play logging
+                if (applet.log_policy != PdmPlayLogPolicy_All) {
+                    continue;
+                }
+
+                e.id = join_u32(applet.program_id);
+                switch (applet.event_type) {
+                    case PdmAppletEventType_InFocus: e.type = PlayEvent::Type::InFocus; break;
+                    case PdmAppletEventType_OutOfFocus:
+                    case PdmAppletEventType_OutOfFocus4: e.type = PlayEvent::Type::OutOfFocus; break;
+                    case PdmAppletEventType_Exit:
+                    case PdmAppletEventType_Exit5:
+                    case PdmAppletEventType_Exit6: e.type = PlayEvent::Type::Exit; break;
+                    default: continue;
+                }
+            } break;
+
+            case PdmPlayEventType_Account: {
+                const auto& account = raw.event_data.account;
+                // 2 and 3 are the network service account becoming (un)available,
+                // which say nothing about whether the user is still playing.
+                switch (account.type) {
+                    case 0: e.type = PlayEvent::Type::AccountOpen; break;
+                    case 1: e.type = PlayEvent::Type::AccountClose; break;
+                    default: e.type = PlayEvent::Type::Other; break;
+                }
+                e.id = join_u32(account.unk_x10.application_info.application_id);
+                e.uid.uid[0] = (static_cast<std::uint64_t>(account.uid[0]) << 32) | account.uid[1];
+                e.uid.uid[1] = (static_cast<std::uint64_t>(account.uid[2]) << 32) | account.uid[3];
+            } break;
+
+            case PdmPlayEventType_PowerStateChange:
+            case PdmPlayEventType_Initialize:
+                e.type = PlayEvent::Type::Suspend;
+                break;
+
+            default:
+                continue;
+        }
+
+        out.emplace_back(e);
+    }
+}
+
+} // namespace
+
+PlaytimeEngine::PlaytimeEngine(AccountUid uid, std::int64_t utc_offset) : uid{uid}, utc_offset{utc_offset} {
+}
+
+void PlaytimeEngine::Update(AppID id, const PlayEvent& e, bool focused, bool user) {
+    auto& session = this->sessions[id];
+    const auto was_active = session.focused && session.user;
+
+    if (was_active && e.steady > session.since) {
+        const auto seconds = e.steady - session.since;
+        this->totals[id] += seconds;
+        const auto local = static_cast<std::int64_t>(session.since_clock) + this->utc_offset;
+        this->history.Add(id, static_cast<std::uint64_t>(std::max<std::int64_t>(local, 0)), seconds);
+    }
+
+    session.focused = focused;
+    session.user = user;
+    session.since = e.steady;
+    session.since_clock = e.clock;
+}
+
+void PlaytimeEngine::Fold(std::span<const PlayEvent> events) {
+    for (const auto& e : events) {
+        this->event_count++;
+
+        switch (e.type) {
+            case PlayEvent::Type::InFocus: {
+                const auto user = this->sessions[e.id].user;
+                this->Update(e.id, e, true, user);
+            } break;
+
+            case PlayEvent::Type::OutOfFocus: {
+                const auto user = this->sessions[e.id].user;
+                this->Update(e.id, e, false, user);
+            } break;
+
+            case PlayEvent::Type::Exit:
+                this->Update(e.id, e, false, false);
+                break;
+
+            case PlayEvent::Type::AccountOpen:
+            case PlayEvent::Type::AccountClose:
+                if (same_uid(e.uid, this->uid)) {
+                    const auto focused = this->sessions[e.id].focused;
+                    this->Update(e.id, e, focused, e.type == PlayEvent::Type::AccountOpen);
+                }
+                break;
+
+            // pdm logs InFocus again once a title is back in the foreground.
+            case PlayEvent::Type::Suspend:
+                for (auto& [id, session] : this->sessions) {
+                    if (session.focused) {
+                        this->Update(id, e, false, session.user);
+                    }
+                }
+                break;
+
+            case PlayEvent::Type::Other:
+                break;
+        }
+    }
+
+    this->history.Flush();
+}
+
+std::uint64_t PlaytimeEngine::Seconds(AppID id) const {
+    if (const auto it = this->totals.find(id); it != this->totals.end()) {
+        return it->second;
+    }
+    return 0;
+}
+
+void PlaytimeEngine::Serialize(std::vector<std::uint8_t>& out) const {
+    util::ByteWriter writer{out};
+    writer.put(this->event_count);
+
+    writer.put(static_cast<std::uint32_t>(this->totals.size()));
+    for (const auto& [id, seconds] : this->totals) {
+        writer.put(id);
+        writer.put(seconds);
+    }
+
+    // idle sessions carry no state, no need to keep them.
+    std::uint32_t open{};
+    for (const auto& [id, session] : this->sessions) {
+        open += session.focused || session.user;
+    }
+
+    writer.put(open);
+    for (const auto& [id, session] : this->sessions) {
+        if (session.focused || session.user) {
+            writer.put(id);
+            writer.put(session.since);
+            writer.put(session.since_clock);
+            writer.put(static_cast<std::uint8_t>(session.focused));
+            writer.put(static_cast<std::uint8_t>(session.user));
+        }
+    }
+
+    this->history.Encode(out);
+}
+
+bool PlaytimeEngine::Deserialize(std::span<const std::uint8_t> in) {
+    util::ByteReader reader{in};
+    std::uint64_t event_count{};
+    std::uint32_t count{};
+    decltype(this->totals) totals;
+    decltype(this->sessions) sessions;
+
+    if (!reader.get(event_count) || !reader.get(count)) {
+        return false;
+    }
+
+    totals.reserve(count);
+    for (std::uint32_t i = 0; i < count; i++) {
+        AppID id{};
+        std::uint64_t seconds{};
+        if (!reader.get(id) || !reader.get(seconds)) {
+            return false;
+        }
+        totals.emplace(id, seconds);
+    }
+
+    if (!reader.get(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; i++) {
+        AppID id{};
+        Session session{};
+        std::uint8_t focused{}, user{};
+        if (!reader.get(id) || !reader.get(session.since) || !reader.get(session.since_clock) || !reader.get(focused) || !reader.get(user)) {
+            return false;
+        }
+        session.focused = focused;
+        session.user = user;
+        sessions.emplace(id, session);
+    }
+
+    PlayHistory history;
+    if (!history.Decode(reader.rest())) {
+        return false;
+    }
+
+    this->event_count = event_count;
+    this->totals = std::move(totals);
+    this->sessions = std::move(sessions);
+    this->history = std::move(history);
+    return true;
+}
+
+std::int64_t LocalUtcOffset() {
+    u64 now{};
+    TimeCalendarTime calendar{};
+    TimeCalendarAdditionalInfo info{};
+    if (R_FAILED(timeGetCurrentTime(TimeType_UserSystemClock, &now)) || R_FAILED(timeToCalendarTimeWithMyRule(now, &calendar, &info))) {
+        return 0;
+    }
+    return info.offset;
+}
+
+std::uint32_t LocalToday(std::int64_t utc_offset) {
+    using namespace std::chrono;
+    const auto now = duration_cast<seconds>(system_clock::now().time_since_epoch()).count() + utc_offset;
+    return static_cast<std::uint32_t>(std::max<std::int64_t>(now, 0) / PlayHistory::SECONDS_PER_DAY);
+}
+
+bool IsCursorValid(const PlayCursor& cursor) {
+    s32 total{}, start{}, end{};
+    if (R_FAILED(pdmqryGetAvailablePlayEventRange(&total, &start, &end))) {
+        return false;
+    }
+
+    // nothing read yet, only fine if nothing was rotated out either.
+    if (cursor.next_index == 0) {
+        return start == 0;
+    }
+
+    // the last event read has to still be there, and be the same one.
+    const auto last = cursor.next_index - 1;
+    if (last < start || last > end) {
+        return false;
+    }
+
+    PdmPlayEvent event{};
+    s32 count{};
+    if (R_FAILED(pdmqryQueryPlayEvent(last, &event, 1, &count)) || count != 1) {
+        return false;
+    }
+
+    return event.timestamp_user == cursor.last_clock && event.timestamp_steady == cursor.last_steady;
+}
+
+Result FoldPlayEvents(PlaytimeEngine& engine, PlayCursor& cursor, std::stop_token stop_token) {
+    // a handful of ipc calls instead of one per title.
+    constexpr s32 BATCH_SIZE = 1024;
+    std::vector<PdmPlayEvent> raw(BATCH_SIZE);
+    std::vector<PlayEvent> events;
+    events.reserve(BATCH_SIZE);
+    Result result{};
+
+    while (!stop_token.stop_requested()) {
+        s32 count{};
+        result = pdmqryQueryPlayEvent(cursor.next_index, raw.data(), BATCH_SIZE, &count);
+        if (R_FAILED(result) || count <= 0) {
+            break;
+        }
+
+        ConvertPlayEvents(std::span{raw}.first(count), events);
+        engine.Fold(events);
+        cursor.next_index += count;
+        cursor.last_clock = raw[count - 1].timestamp_user;
+        cursor.last_steady = raw[count - 1].timestamp_steady;
+    }
+
+    return result;
+}
+
+} // namespace tj
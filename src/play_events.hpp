@@ -0,0 +1,97 @@
+#pragma once
+
+#include "play_history.hpp"
+
+#include <switch.h>
+#include <cstdint>
+#include <span>
+#include <stop_token>
+#include <unordered_map>
+#include <vector>
+
+namespace tj {
+
+using AppID = std::uint64_t;
+
+// pdm play event with only the bits we need, so that the folding below
+// doesn't care where the events came from.
+struct PlayEvent final {
+    enum class Type : std::uint8_t {
+        InFocus,
+        OutOfFocus,
+        Exit,
+        AccountOpen,    // a user opened the application
+        AccountClose,
+        Suspend,        // power state change / boot, nothing is in focus after
+        Other,
+    };
+
+    Type type;
+    AppID id;
+    AccountUid uid;         // only set for account events
+    std::uint64_t clock;    // posix seconds, user clock
+    std::uint64_t steady;   // seconds, steady clock
+};
+
+// folds play events into per title playtime of a single user, in one pass.
+// time is counted while a title is in focus and the user has it open.
+class PlaytimeEngine final {
+public:
+    // utc_offset is added to event clocks so days are cut at local midnight.
+    PlaytimeEngine(AccountUid uid, std::int64_t utc_offset);
+
+    void Fold(std::span<const PlayEvent> events);
+
+    // seconds played, 0 if the title never showed up.
+    [[nodiscard]] std::uint64_t Seconds(AppID id) const;
+    [[nodiscard]] const auto& Totals() const { return this->totals; }
+    [[nodiscard]] std::uint64_t EventCount() const { return this->event_count; }
+    // the same time, split up per day.
+    [[nodiscard]] const PlayHistory& History() const { return this->history; }
+
+    // totals and open sessions, so that folding can carry on later.
+    void Serialize(std::vector<std::uint8_t>& out) const;
+    [[nodiscard]] bool Deserialize(std::span<const std::uint8_t> in);
+
+private:
+    struct Session {
+        std::uint64_t since;
+        std::uint64_t since_clock;
+        bool focused;
+        bool user;
+    };
+
+    void Update(AppID id, const PlayEvent& e, bool focused, bool user);
+
+    AccountUid uid;
+    std::int64_t utc_offset;
+    std::unordered_map<AppID, std::uint64_t> totals{};
+    std::unordered_map<AppID, Session> sessions{};
+    PlayHistory history{};
+    std::uint64_t event_count{};
+};
+
+// how far the event log has been folded, the timestamps of the last event
+// read are kept to notice if the log was rotated / reset since.
+struct PlayCursor final {
+    s32 next_index;
+    std::uint64_t last_clock;
+    std::uint64_t last_steady;
+};
+
+// seconds the console's local time is ahead of utc right now, 0 if the
+// time service can't tell. taken once per scan, so a dst change in the
+// middle of the history shifts the older days by an hour.
+[[nodiscard]] std::int64_t LocalUtcOffset();
+
+// days since the unix epoch at the console's local time.
+[[nodiscard]] std::uint32_t LocalToday(std::int64_t utc_offset);
+
+// true if the log still has the events the cursor was built from.
+[[nodiscard]] bool IsCursorValid(const PlayCursor& cursor);
+
+// folds the pdm play event log into the engine in large batches, starting
+// at the cursor, which is moved past the last event read.
+Result FoldPlayEvents(PlaytimeEngine& engine, PlayCursor& cursor, std::stop_token stop_token);
+
+} // namespace tj
@@ -0,0 +1,336 @@
+#include "play_history.hpp"
+#include "byte_io.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace tj {
+
+void PlayHistory::Add(std::uint64_t id, std::uint64_t clock, std::uint64_t seconds) {
+    while (seconds) {
+        const auto day = clock / SECONDS_PER_DAY;
+        const auto part = std::min(seconds, (day + 1) * SECONDS_PER_DAY - clock);
+        this->pending[{id, static_cast<std::uint32_t>(day)}] += part;
+        clock += part;
+        seconds -= part;
+    }
+}
+
+void PlayHistory::Flush() {
+    if (this->pending.empty()) {
+        return;
+    }
+
+    // both sides are sorted by (title, day), so this is a single merge.
+    std::vector<std::uint64_t> titles;
+    std::vector<std::uint32_t> offsets{0};
+    std::vector<std::uint32_t> days;
+    std::vector<std::uint32_t> seconds;
+    std::vector<std::uint64_t> prefix;
+    titles.reserve(this->titles.size() + this->pending.size());
+    days.reserve(this->days.size() + this->pending.size());
+    seconds.reserve(this->seconds.size() + this->pending.size());
+    prefix.reserve(this->prefix.size() + this->pending.size());
+
+    const auto push = [&](std::uint64_t id, std::uint32_t day, std::uint64_t value) {
+        if (titles.empty() || titles.back() != id) {
+            if (!titles.empty()) {
+                offsets.emplace_back(days.size());
+            }
+            titles.emplace_back(id);
+        }
+
+        const auto same_title = offsets.back() != days.size();
+        value = std::min<std::uint64_t>(value, std::numeric_limits<std::uint32_t>::max());
+        if (same_title && days.back() == day) {
+            value = std::min<std::uint64_t>(value, std::numeric_limits<std::uint32_t>::max() - seconds.back());
+            seconds.back() += value;
+            prefix.back() += value;
+        } else {
+            days.emplace_back(day);
+            seconds.emplace_back(value);
+            prefix.emplace_back(same_title ? prefix.back() + value : value);
+        }
+    };
+
+    std::size_t title = 0;
+    std::size_t row = 0;
+    auto it = this->pending.begin();
+    while (row < this->days.size() || it != this->pending.end()) {
+        while (row < this->days.size() && row == this->offsets[title + 1]) {
+            title++;
+        }
+
+        const bool take_old = it == this->pending.end() ||
+            (row < this->days.size() && std::pair{this->titles[title], this->days[row]} <= it->first);
+
+        if (take_old) {
+            push(this->titles[title], this->days[row], this->seconds[row]);
+            row++;
+        } else {
+            push(it->first.first, it->first.second, it->second);
+            ++it;
+        }
+    }
+    offsets.emplace_back(days.size());
+
+    // only days from the earliest one added onwards need their totals updated,
+    // which is just the last few when new days are appended.
+    auto first = std::numeric_limits<std::uint32_t>::max();
+    auto last = std::numeric_limits<std::uint32_t>::min();
+    for (const auto& [key, value] : this->pending) {
+        first = std::min(first, key.second);
+        last = std::max(last, key.second);
+    }
+
+    std::vector<std::uint64_t> per_day(last - first + 1);
+    for (const auto& [key, value] : this->pending) {
+        per_day[key.second - first] += value;
+    }
+
+    this->titles = std::move(titles);
+    this->offsets = std::move(offsets);
+    this->days = std::move(days);
+    this->seconds = std::move(seconds);
+    this->prefix = std::move(prefix);
+    this->pending.clear();
+    this->AddTotals(first, last, per_day);
+
+    assert(this->Verify() && "running totals don't match the rows");
+}
+
+void PlayHistory::AddTotals(std::uint32_t first, std::uint32_t last, std::span<const std::uint64_t> per_day) {
+    if (this->totals.empty()) {
+        this->first_day = first;
+    } else if (first < this->first_day) {
+        this->totals.insert(this->totals.begin(), this->first_day - first, 0);
+        this->first_day = first;
+    }
+
+    const std::size_t end = last - this->first_day + 1;
+    if (end > this->totals.size()) {
+        this->totals.resize(end, this->totals.empty() ? 0 : this->totals.back());
+    }
+
+    std::uint64_t running{};
+    for (std::size_t i = first - this->first_day; i < this->totals.size(); i++) {
+        const std::size_t day = i + this->first_day - first;
+        if (day < per_day.size()) {
+            running += per_day[day];
+        }
+        this->totals[i] += running;
+    }
+}
+
+void PlayHistory::RebuildTotals() {
+    this->prefix.resize(this->days.size());
+    this->totals.clear();
+    if (this->days.empty()) {
+        return;
+    }
+
+    const auto [first, last] = std::ranges::minmax(this->days);
+    std::vector<std::uint64_t> per_day(last - first + 1);
+    for (std::size_t i = 0; i < this->titles.size(); i++) {
+        std::uint64_t running{};
+        for (auto row = this->offsets[i]; row < this->offsets[i + 1]; row++) {
+            running += this->seconds[row];
+            this->prefix[row] = running;
+            per_day[this->days[row] - first] += this->seconds[row];
+        }
+    }
+
+    this->AddTotals(first, last, per_day);
+}
+
+#ifndef NDEBUG
+bool PlayHistory::Verify() const {
+    for (std::size_t i = 0; i < this->titles.size(); i++) {
+        std::uint64_t running{};
+        for (auto row = this->offsets[i]; row < this->offsets[i + 1]; row++) {
+            running += this->seconds[row];
+            if (this->prefix[row] != running) {
+                return false;
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> per_day(this->totals.size());
+    for (std::size_t row = 0; row < this->days.size(); row++) {
+        per_day[this->days[row] - this->first_day] += this->seconds[row];
+    }
+
+    std::uint64_t running{};
+    for (std::size_t i = 0; i < per_day.size(); i++) {
+        running += per_day[i];
+        if (this->totals[i] != running) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+std::uint64_t PlayHistory::TotalUpTo(std::uint32_t day) const {
+    if (this->totals.empty() || day < this->first_day) {
+        return 0;
+    }
+    return this->totals[std::min<std::size_t>(day - this->first_day, this->totals.size() - 1)];
+}
+
+std::uint64_t PlayHistory::Total(std::uint32_t first_day, std::uint32_t last_day) const {
+    if (first_day > last_day) {
+        return 0;
+    }
+    return this->TotalUpTo(last_day) - (first_day ? this->TotalUpTo(first_day - 1) : 0);
+}
+
+std::int64_t PlayHistory::Find(std::uint64_t id) const {
+    const auto it = std::ranges::lower_bound(this->titles, id);
+    if (it == this->titles.end() || *it != id) {
+        return -1;
+    }
+    return std::distance(this->titles.begin(), it);
+}
+
+std::span<const std::uint32_t> PlayHistory::Days(std::size_t title) const {
+    return std::span{this->days}.subspan(this->offsets[title], this->offsets[title + 1] - this->offsets[title]);
+}
+
+std::span<const std::uint32_t> PlayHistory::Seconds(std::size_t title) const {
+    return std::span{this->seconds}.subspan(this->offsets[title], this->offsets[title + 1] - this->offsets[title]);
+}
+
+std::uint64_t PlayHistory::Range(std::uint64_t id, std::uint32_t first_day, std::uint32_t last_day) const {
+    const auto title = this->Find(id);
+    if (title < 0 || first_day > last_day) {
+        return 0;
+    }
+
+    const auto days = this->Days(title);
+    const auto begin = std::ranges::lower_bound(days, first_day) - days.begin();
+    const auto end = std::ranges::upper_bound(days, last_day) - days.begin();
+    if (begin == end) {
+        return 0;
+    }
+
+    const auto prefix = std::span{this->prefix}.subspan(this->offsets[title], days.size());
+    return prefix[end - 1] - (begin ? prefix[begin - 1] : 0);
+}
+
+void PlayHistory::Encode(std::vector<std::uint8_t>& out) const {
+    util::ByteWriter writer{out};
+    writer.put_varint(this->titles.size());
+    writer.put_varint(this->days.size());
+
+    // one column after another, deltas keep most values in a byte or two.
+    std::uint64_t prev_id{};
+    for (const auto id : this->titles) {
+        writer.put_varint(id - prev_id);
+        prev_id = id;
+    }
+
+    for (std::size_t i = 0; i < this->titles.size(); i++) {
+        writer.put_varint(this->offsets[i + 1] - this->offsets[i]);
+    }
+
+    for (std::size_t i = 0; i < this->titles.size(); i++) {
+        std::uint32_t prev_day{};
+        for (const auto day : this->Days(i)) {
+            writer.put_varint(day - prev_day);
+            prev_day = day;
+        }
+    }
+
+    for (const auto value : this->seconds) {
+        writer.put_varint(value);
+    }
+}
+
+bool PlayHistory::Decode(std::span<const std::uint8_t> in) {
+    util::ByteReader reader{in};
+    std::uint64_t title_count{}, row_count{};
+    if (!reader.get_varint(title_count) || !reader.get_varint(row_count)) {
+        return false;
+    }
+
+    // every value takes at least a byte, so bad counts are caught early.
+    const auto remaining = reader.remaining();
+    if (title_count > remaining || row_count > remaining || title_count * 2 + row_count * 2 > remaining) {
+        return false;
+    }
+
+    std::vector<std::uint64_t> titles(title_count);
+    std::vector<std::uint32_t> offsets(title_count + 1);
+    std::vector<std::uint32_t> days(row_count);
+    std::vector<std::uint32_t> seconds(row_count);
+
+    // nothing is checksummed, so anything Find() / Range() binary search
+    // has to be strictly ascending, or they'd quietly answer wrong.
+    std::uint64_t id{};
+    for (std::size_t i = 0; i < title_count; i++) {
+        std::uint64_t delta{};
+        if (!reader.get_varint(delta) || (i && !delta) || id + delta < id) {
+            return false;
+        }
+        id += delta;
+        titles[i] = id;
+    }
+
+    for (std::size_t i = 0; i < title_count; i++) {
+        std::uint64_t count{};
+        if (!reader.get_varint(count) || offsets[i] + count > row_count) {
+            return false;
+        }
+        offsets[i + 1] = offsets[i] + count;
+    }
+
+    if (offsets.back() != row_count) {
+        return false;
+    }
+
+    std::uint32_t first_day{std::numeric_limits<std::uint32_t>::max()};
+    std::uint32_t last_day{};
+    for (std::size_t i = 0; i < title_count; i++) {
+        std::uint64_t day{};
+        for (auto row = offsets[i]; row < offsets[i + 1]; row++) {
+            std::uint64_t delta{};
+            if (!reader.get_varint(delta) || (row != offsets[i] && !delta) || delta > std::numeric_limits<std::uint32_t>::max() - day) {
+                return false;
+            }
+            day += delta;
+            days[row] = static_cast<std::uint32_t>(day);
+        }
+
+        if (offsets[i] != offsets[i + 1]) {
+            first_day = std::min(first_day, days[offsets[i]]);
+            last_day = std::max(last_day, days[offsets[i + 1] - 1]);
+        }
+    }
+
+    // the totals get a slot per day in between.
+    if (row_count && last_day - first_day > MAX_DAY_SPAN) {
+        return false;
+    }
+
+    for (auto& value : seconds) {
+        std::uint64_t v{};
+        if (!reader.get_varint(v) || v > std::numeric_limits<std::uint32_t>::max()) {
+            return false;
+        }
+        value = static_cast<std::uint32_t>(v);
+    }
+
+    this->titles = std::move(titles);
+    this->offsets = std::move(offsets);
+    this->days = std::move(days);
+    this->seconds = std::move(seconds);
+    this->pending.clear();
+    this->RebuildTotals();
+
+    assert(this->Verify() && "running totals don't match the rows");
+    return true;
+}
+
+} // namespace tj
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tj {
+
+// per title, per day play seconds.
+// rows are sorted by title then day and kept as separate columns, the title
+// column is run length encoded as offsets into the day / seconds columns.
+// days are counted from the unix epoch, in the console's local time.
+// running totals are kept next to the rows, per title and for every title
+// combined, so range totals don't have to add up rows.
+class PlayHistory final {
+public:
+    static constexpr std::uint64_t SECONDS_PER_DAY{60 * 60 * 24};
+    // a century, more than that between the first and last day played
+    // can only come from a corrupted cache.
+    static constexpr std::uint32_t MAX_DAY_SPAN{366 * 100};
+
+    // adds time played from clock onwards, split at midnight. clock is
+    // posix seconds already shifted to local time, see LocalUtcOffset().
+    // nothing is visible to queries until Flush() is called.
+    void Add(std::uint64_t id, std::uint64_t clock, std::uint64_t seconds);
+    // merges everything added since the last flush into the columns.
+    void Flush();
+
+    // seconds played of a title in [first_day, last_day], O(log n).
+    [[nodiscard]] std::uint64_t Range(std::uint64_t id, std::uint32_t first_day, std::uint32_t last_day) const;
+    // seconds played of every title in [first_day, last_day], O(1).
+    [[nodiscard]] std::uint64_t Total(std::uint32_t first_day, std::uint32_t last_day) const;
+    // index of the title, or -1 if it was never played.
+    [[nodiscard]] std::int64_t Find(std::uint64_t id) const;
+
+    [[nodiscard]] std::size_t TitleCount() const { return this->titles.size(); }
+    [[nodiscard]] std::size_t RowCount() const { return this->days.size(); }
+    [[nodiscard]] std::span<const std::uint32_t> Days(std::size_t title) const;
+    [[nodiscard]] std::span<const std::uint32_t> Seconds(std::size_t title) const;
+
+    // ids and days are delta encoded, everything is a varint.
+    void Encode(std::vector<std::uint8_t>& out) const;
+    // false if the data is truncated, out of order or out of range.
+    [[nodiscard]] bool Decode(std::span<const std::uint8_t> in);
+
+private:
+    // seconds of every title up to and including the day.
+    [[nodiscard]] std::uint64_t TotalUpTo(std::uint32_t day) const;
+    void AddTotals(std::uint32_t first, std::uint32_t last, std::span<const std::uint64_t> per_day);
+    void RebuildTotals();
+#ifndef NDEBUG
+    // checks the running totals against summing up the rows.
+    [[nodiscard]] bool Verify() const;
+#endif
+
+    std::vector<std::uint64_t> titles{};        // title index -> id, ascending
+    std::vector<std::uint32_t> offsets{0};      // title index -> first row, one past the end last
+    std::vector<std::uint32_t> days{};
+    std::vector<std::uint32_t> seconds{};
+    std::vector<std::uint64_t> prefix{};        // running total of the title's rows
+
+    std::uint32_t first_day{};
+    std::vector<std::uint64_t> totals{};        // running total of every title, one per day
+
+    std::map<std::pair<std::uint64_t, std::uint32_t>, std::uint64_t> pending{};
+};
+
+} // namespace tj
@@ -8,6 +8,14 @@ Playtime::Playtime(u64 hours, u64 minutes, u64 seconds)
     : hours(hours), minutes(minutes), seconds(seconds) {
 }
 
+Playtime Playtime::fromSeconds(u64 seconds) {
+    const u64 hours = seconds / 3600;
+    seconds -= hours * 3600;
+    const u64 minutes = seconds / 60;
+    seconds -= minutes * 60;
+    return Playtime(hours, minutes, seconds);
+}
+
 std::string Playtime::toString() {
     return string_format("%02d:%02d:%02d", this->hours, this->minutes, this->seconds);
 }
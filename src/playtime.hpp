@@ -11,6 +11,8 @@ public:
     Playtime();
     Playtime(u64 hours, u64 minutes, u64 seconds);
 
+    static Playtime fromSeconds(u64 seconds);
+
     std::string toString();
 
     u64 totalSeconds();
@@ -0,0 +1,63 @@
+#include "playtime_stats.hpp"
+
+#include <algorithm>
+
+namespace tj {
+
+auto PlaytimeStats::Compute(const TitleTable& titles, std::span<const TitleTable::Row> rows) -> PlaytimeStats {
+    PlaytimeStats stats;
+    stats.count = rows.size();
+    if (rows.empty()) {
+        return stats;
+    }
+
+    const auto seconds = titles.SecondsColumn();
+    std::vector<std::uint64_t> values;
+    values.reserve(rows.size());
+    for (const auto row : rows) {
+        const auto value = seconds[row];
+        values.emplace_back(value);
+        stats.total += value;
+        stats.played += value != 0;
+        stats.histogram[Bucket(value)]++;
+    }
+
+    stats.mean = stats.total / stats.count;
+
+    // after the first selection nothing from n / 2 on is smaller than the
+    // median, so the p90 only has to be looked for in that half.
+    const auto n = values.size();
+    const auto select = [&values](std::size_t first, std::size_t k) {
+        std::nth_element(values.begin() + first, values.begin() + k, values.end());
+        return values[k];
+    };
+
+    const auto upper = select(0, n / 2);
+    if (n % 2) {
+        stats.median = upper;
+    } else {
+        // everything before n / 2 is no bigger, so the lower middle is their max.
+        const auto lower = *std::max_element(values.begin(), values.begin() + n / 2);
+        stats.median = lower + (upper - lower) / 2;
+    }
+
+    // nearest rank, never below n / 2
+    stats.p90 = select(n / 2, (n * 9 + 9) / 10 - 1);
+
+    const auto top_count = std::min(TOP_COUNT, n);
+    stats.top.assign(rows.begin(), rows.end());
+    std::partial_sort(stats.top.begin(), stats.top.begin() + top_count, stats.top.end(), [&](auto a, auto b) {
+        return seconds[a] != seconds[b] ? seconds[a] > seconds[b] : titles.NameLess(a, b);
+    });
+    stats.top.resize(top_count);
+
+    return stats;
+}
+
+auto PlaytimeStats::Bucket(std::uint64_t seconds) -> std::size_t {
+    const auto hours = seconds / (60 * 60);
+    const auto it = std::upper_bound(BUCKET_HOURS.begin(), BUCKET_HOURS.end(), hours);
+    return static_cast<std::size_t>(it - BUCKET_HOURS.begin()) - 1;
+}
+
+} // namespace tj
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "title_table.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace tj {
+
+// summary of the playtime column over a set of rows.
+// sums and the histogram are gathered in one pass, the percentiles and the
+// top titles use selection rather than sorting every row.
+struct PlaytimeStats final {
+    static constexpr std::size_t TOP_COUNT{10};
+    // lower edge of each histogram bucket in hours, the last is open ended.
+    static constexpr std::array<std::uint64_t, 8> BUCKET_HOURS{0, 1, 5, 10, 25, 50, 100, 250};
+
+    std::vector<TitleTable::Row> top{}; // most played first
+    std::array<std::uint32_t, BUCKET_HOURS.size()> histogram{};
+    std::size_t count{};
+    std::size_t played{}; // titles with any playtime
+    std::uint64_t total{};
+    std::uint64_t mean{};
+    std::uint64_t median{};
+    std::uint64_t p90{};
+
+    [[nodiscard]] static PlaytimeStats Compute(const TitleTable& titles, std::span<const TitleTable::Row> rows);
+    [[nodiscard]] static std::size_t Bucket(std::uint64_t seconds);
+};
+
+} // namespace tj
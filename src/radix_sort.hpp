@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace util {
+
+// stable lsd radix sort of items by a u64 key, smallest key first.
+// keys are looked up once per item and sorted along with them, a byte per
+// pass, skipping passes where every key has the same byte.
+template<typename T, typename KeyFn>
+void radix_sort(std::span<T> items, KeyFn&& key_fn) {
+    struct Pair {
+        std::uint64_t key;
+        T item;
+    };
+
+    constexpr std::size_t PASSES = sizeof(std::uint64_t);
+    constexpr std::size_t BUCKETS = 256;
+
+    if (items.size() < 2) {
+        return;
+    }
+
+    std::vector<Pair> a(items.size());
+    std::vector<Pair> b(items.size());
+    std::array<std::array<std::size_t, BUCKETS>, PASSES> counts{};
+
+    // every histogram in one go.
+    for (std::size_t i = 0; i < items.size(); i++) {
+        const std::uint64_t key = key_fn(items[i]);
+        a[i] = {key, items[i]};
+        for (std::size_t pass = 0; pass < PASSES; pass++) {
+            counts[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    for (std::size_t pass = 0; pass < PASSES; pass++) {
+        auto& count = counts[pass];
+        const auto shift = pass * 8;
+
+        // the byte is the same for every key, nothing would move.
+        if (count[(a[0].key >> shift) & 0xFF] == items.size()) {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (auto& c : count) {
+            const auto n = c;
+            c = offset;
+            offset += n;
+        }
+
+        for (const auto& pair : a) {
+            b[count[(pair.key >> shift) & 0xFF]++] = pair;
+        }
+        a.swap(b);
+    }
+
+    for (std::size_t i = 0; i < items.size(); i++) {
+        items[i] = a[i].item;
+    }
+}
+
+} // namespace util
@@ -0,0 +1,101 @@
+#include "scan_progress.hpp"
+
+#include <algorithm>
+
+namespace tj {
+
+void ScanProgress::Start() {
+    this->total.reset();
+    this->records_listed.reset();
+    this->control_data_fetched.reset();
+    this->stats_queried.reset();
+    this->events_read.reset();
+    this->icons_decoded.reset();
+    this->failures.reset();
+    this->metadata_done.reset();
+    this->titles_done.reset();
+    this->metadata_end_ns.reset();
+    this->stats_start_ns.reset();
+    this->start_ns.store(util::instrument::now());
+}
+
+void ScanProgress::EndMetadata() {
+    this->metadata_end_ns.store(util::instrument::now());
+}
+
+void ScanProgress::StartStats() {
+    this->stats_start_ns.store(util::instrument::now());
+}
+
+void ScanProgress::Register() {
+    auto& registry = util::instrument::Registry::get();
+    registry.add("scan.total", this->total);
+    registry.add("scan.records_listed", this->records_listed);
+    registry.add("scan.control_data_fetched", this->control_data_fetched);
+    registry.add("scan.stats_queried", this->stats_queried);
+    registry.add("scan.events_read", this->events_read);
+    registry.add("scan.icons_decoded", this->icons_decoded);
+    registry.add("scan.failures", this->failures);
+    registry.add("scan.metadata_done", this->metadata_done);
+    registry.add("scan.titles_done", this->titles_done);
+}
+
+void ScanProgress::Unregister() {
+    auto& registry = util::instrument::Registry::get();
+    registry.remove(this->total);
+    registry.remove(this->records_listed);
+    registry.remove(this->control_data_fetched);
+    registry.remove(this->stats_queried);
+    registry.remove(this->events_read);
+    registry.remove(this->icons_decoded);
+    registry.remove(this->failures);
+    registry.remove(this->metadata_done);
+    registry.remove(this->titles_done);
+}
+
+ScanProgress::Snapshot ScanProgress::Sample() const {
+    Snapshot s{};
+    s.total = this->total.load();
+    s.records_listed = this->records_listed.load();
+    s.control_data_fetched = this->control_data_fetched.load();
+    s.stats_queried = this->stats_queried.load();
+    s.icons_decoded = this->icons_decoded.load();
+    s.failures = this->failures.load();
+    s.metadata_done = this->metadata_done.load();
+    s.titles_done = this->titles_done.load();
+
+    const auto now = util::instrument::now();
+    const auto start = this->start_ns.load();
+    const auto metadata_end = this->metadata_end_ns.load();
+    const auto stats_start = this->stats_start_ns.load();
+    const auto seconds_between = [](std::uint64_t from, std::uint64_t to) {
+        return from && to > from ? static_cast<double>(to - from) / 1e9 : 0.0;
+    };
+
+    // each phase is timed on its own, leaving out the user selector.
+    const auto metadata_seconds = seconds_between(start, metadata_end ? metadata_end : now);
+    const auto stats_seconds = seconds_between(stats_start, now);
+    s.elapsed_seconds = seconds_between(start, now);
+    if (stats_start) {
+        s.titles_per_second = stats_seconds > 0.0 ? static_cast<double>(s.titles_done) / stats_seconds : 0.0;
+    } else {
+        s.titles_per_second = metadata_seconds > 0.0 ? static_cast<double>(s.metadata_done) / metadata_seconds : 0.0;
+    }
+    s.eta_seconds = -1.0;
+
+    // each title is scanned twice, once for metadata and once for stats.
+    if (s.total) {
+        const auto units_total = 2 * s.total;
+        const auto units_done = std::min(units_total, s.metadata_done + s.titles_done);
+        s.fraction = static_cast<float>(units_done) / static_cast<float>(units_total);
+        const auto work_seconds = metadata_seconds + stats_seconds;
+        if (work_seconds > 0.0 && units_done) {
+            const auto units_per_second = static_cast<double>(units_done) / work_seconds;
+            s.eta_seconds = static_cast<double>(units_total - units_done) / units_per_second;
+        }
+    }
+
+    return s;
+}
+
+} // namespace tj
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "instrumentation.hpp"
+
+#include <cstdint>
+
+namespace tj {
+
+// published by the scan thread, read by the ui every frame.
+struct ScanProgress final {
+    util::instrument::Counter total;                // titles to scan, 0 until listing is done
+    util::instrument::Counter records_listed;
+    util::instrument::Counter control_data_fetched;
+    util::instrument::Counter stats_queried;
+    util::instrument::Counter events_read;          // pdm play events folded
+    util::instrument::Counter icons_decoded;
+    util::instrument::Counter failures;
+    util::instrument::Counter metadata_done;        // user independent phase
+    util::instrument::Counter titles_done;          // play statistics phase
+    util::instrument::Counter start_ns;             // when the scan started
+    util::instrument::Counter metadata_end_ns;      // when phase 1 finished, 0 until then
+    util::instrument::Counter stats_start_ns;       // when the user was picked, 0 until then
+
+    // plain copy of the counters, with the rates worked out.
+    struct Snapshot {
+        std::uint64_t total;
+        std::uint64_t records_listed;
+        std::uint64_t control_data_fetched;
+        std::uint64_t stats_queried;
+        std::uint64_t icons_decoded;
+        std::uint64_t failures;
+        std::uint64_t metadata_done;
+        std::uint64_t titles_done;
+        double elapsed_seconds;     // wall time, including waiting for the user
+        double titles_per_second;   // of the phase running now
+        double eta_seconds;         // negative if unknown
+        float fraction;             // 0.f-1.f
+    };
+
+    void Start();
+    // the time in between is spent in the user selector, which says
+    // nothing about how fast titles are scanned.
+    void EndMetadata();
+    void StartStats();
+    void Register();
+    void Unregister();
+    [[nodiscard]] Snapshot Sample() const;
+};
+
+} // namespace tj
@@ -0,0 +1,148 @@
+#include "search_index.hpp"
+#include "collation.hpp"
+#include "radix_sort.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace tj {
+namespace {
+
+constexpr std::size_t TRIGRAM{3};
+
+auto trigram_at(std::string_view text, std::size_t i) -> std::uint32_t {
+    return static_cast<std::uint8_t>(text[i]) << 16 | static_cast<std::uint8_t>(text[i + 1]) << 8 | static_cast<std::uint8_t>(text[i + 2]);
+}
+
+// the key is folded utf8, so any ascii byte that isn't alphanumeric
+// separates words.
+auto is_word_start(std::string_view text, std::size_t pos) -> bool {
+    if (pos == 0) {
+        return true;
+    }
+
+    const auto c = static_cast<unsigned char>(text[pos - 1]);
+    return c < 0x80 && !((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'));
+}
+
+auto rank_of(std::string_view name, std::string_view author, std::string_view query) -> std::optional<SearchIndex::Rank> {
+    auto pos = name.find(query);
+    if (pos == 0) {
+        return SearchIndex::Rank_Prefix;
+    }
+
+    if (pos != std::string_view::npos) {
+        for (; pos != std::string_view::npos; pos = name.find(query, pos + 1)) {
+            if (is_word_start(name, pos)) {
+                return SearchIndex::Rank_Word;
+            }
+        }
+        return SearchIndex::Rank_Name;
+    }
+
+    if (author.find(query) != std::string_view::npos) {
+        return SearchIndex::Rank_Author;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+void SearchIndex::Build(const TitleTable& titles) {
+    this->Clear();
+
+    // (trigram, row) pairs, sorted so that each trigram's rows end up together.
+    std::vector<std::uint64_t> pairs;
+    const auto add = [&pairs](std::string_view text, TitleTable::Row row) {
+        for (std::size_t i = 0; i + TRIGRAM <= text.size(); i++) {
+            pairs.emplace_back(static_cast<std::uint64_t>(trigram_at(text, i)) << 32 | row);
+        }
+    };
+
+    this->author_keys.reserve(titles.Size());
+    for (TitleTable::Row row = 0; row < titles.Size(); row++) {
+        const auto author = this->authors.intern(util::collation_key(titles.Author(row)));
+        this->author_keys.emplace_back(author);
+        add(titles.NameKey(row), row);
+        add(this->authors.view(author), row);
+    }
+
+    util::radix_sort(std::span{pairs}, [](auto pair) { return pair; });
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    this->rows.reserve(pairs.size());
+    for (const auto pair : pairs) {
+        const auto trigram = static_cast<std::uint32_t>(pair >> 32);
+        if (this->trigrams.empty() || this->trigrams.back() != trigram) {
+            this->trigrams.emplace_back(trigram);
+            this->offsets.emplace_back(static_cast<std::uint32_t>(this->rows.size()));
+        }
+        this->rows.emplace_back(static_cast<TitleTable::Row>(pair));
+    }
+    this->offsets.emplace_back(static_cast<std::uint32_t>(this->rows.size()));
+}
+
+void SearchIndex::Clear() {
+    this->trigrams.clear();
+    this->offsets.clear();
+    this->rows.clear();
+    this->author_keys.clear();
+    this->authors.clear();
+}
+
+auto SearchIndex::Find(const TitleTable& titles, std::string_view query) const -> std::vector<Match> {
+    std::vector<Match> matches;
+    const auto key = util::collation_key(query);
+    if (key.empty()) {
+        return matches;
+    }
+
+    const auto check = [&](TitleTable::Row row) {
+        if (const auto rank = rank_of(titles.NameKey(row), this->authors.view(this->author_keys[row]), key)) {
+            matches.emplace_back(row, *rank);
+        }
+    };
+
+    // too short for a trigram, every title has to be checked.
+    if (key.size() < TRIGRAM) {
+        for (TitleTable::Row row = 0; row < this->author_keys.size(); row++) {
+            check(row);
+        }
+        return matches;
+    }
+
+    std::vector<std::span<const TitleTable::Row>> lists;
+    for (std::size_t i = 0; i + TRIGRAM <= key.size(); i++) {
+        const auto trigram = trigram_at(key, i);
+        const auto it = std::ranges::lower_bound(this->trigrams, trigram);
+        if (it == this->trigrams.end() || *it != trigram) {
+            return matches;
+        }
+
+        const auto index = it - this->trigrams.begin();
+        lists.emplace_back(std::span{this->rows}.subspan(this->offsets[index], this->offsets[index + 1] - this->offsets[index]));
+    }
+
+    // intersect the shortest lists first, so the candidates shrink quickly.
+    std::ranges::sort(lists, {}, &std::span<const TitleTable::Row>::size);
+    std::vector<TitleTable::Row> candidates{lists.front().begin(), lists.front().end()};
+    std::vector<TitleTable::Row> next;
+    for (std::size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+        next.clear();
+        std::ranges::set_intersection(candidates, lists[i], std::back_inserter(next));
+        std::swap(candidates, next);
+    }
+
+    // having every trigram doesn't mean they are next to each other.
+    for (const auto row : candidates) {
+        check(row);
+    }
+
+    return matches;
+}
+
+} // namespace tj
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "title_table.hpp"
+#include "string_arena.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace tj {
+
+// trigram index over the folded name and author of every title, so that
+// a search only has to check the few titles that contain every trigram
+// of the query instead of every title.
+// text is folded with util::collation_key() so that case, accents and
+// full width letters don't matter.
+class SearchIndex final {
+public:
+    // better matches first.
+    enum Rank : std::uint8_t {
+        Rank_Prefix,    // the name starts with the query
+        Rank_Word,      // a word in the name starts with the query
+        Rank_Name,      // somewhere in the name
+        Rank_Author,
+    };
+
+    struct Match {
+        TitleTable::Row row;
+        Rank rank;
+    };
+
+    // titles has to be the same table that is later passed to Find().
+    void Build(const TitleTable& titles);
+    void Clear();
+
+    // every title matching the query, in row order.
+    [[nodiscard]] std::vector<Match> Find(const TitleTable& titles, std::string_view query) const;
+
+    [[nodiscard]] std::size_t Size() const { return this->author_keys.size(); }
+
+private:
+    // posting lists, rows[offsets[i]..offsets[i + 1]] contain trigrams[i].
+    std::vector<std::uint32_t> trigrams{};
+    std::vector<std::uint32_t> offsets{};
+    std::vector<TitleTable::Row> rows{};
+    // names are already folded by the table, authors are folded here.
+    std::vector<util::StringArena::Ref> author_keys{};
+    util::StringArena authors{};
+};
+
+} // namespace tj
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace util {
+
+// bounded lock-free queue for exactly one producer and one consumer thread.
+// head is only written by the consumer and tail only by the producer, each
+// side caches the other's index so the shared cache line is only read when
+// the queue looks full / empty.
+template<typename T, std::size_t Capacity>
+class SpscQueue final {
+    static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>);
+
+public:
+    // producer only, false if the queue is full.
+    [[nodiscard]]
+    bool try_push(T&& value) {
+        const auto tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - this->cached_head == Capacity) {
+            this->cached_head = this->head.load(std::memory_order_acquire);
+            if (tail - this->cached_head == Capacity) {
+                return false;
+            }
+        }
+
+        this->slots[tail & (Capacity - 1)] = std::move(value);
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only, false if the queue is empty.
+    [[nodiscard]]
+    bool try_pop(T& out) {
+        const auto head = this->head.load(std::memory_order_relaxed);
+        if (head == this->cached_tail) {
+            this->cached_tail = this->tail.load(std::memory_order_acquire);
+            if (head == this->cached_tail) {
+                return false;
+            }
+        }
+
+        out = std::move(this->slots[head & (Capacity - 1)]);
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // pops everything currently queued, consumer only.
+    template<typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t count{};
+        T value;
+        while (this->try_pop(value)) {
+            fn(std::move(value));
+            count++;
+        }
+        return count;
+    }
+
+    [[nodiscard]]
+    static constexpr auto capacity() noexcept {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE{64};
+
+    // consumer side
+    alignas(CACHE_LINE) std::atomic<std::size_t> head{0};
+    std::size_t cached_tail{0};
+    // producer side
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail{0};
+    std::size_t cached_head{0};
+
+    alignas(CACHE_LINE) std::array<T, Capacity> slots{};
+};
+
+} // namespace util
@@ -0,0 +1,88 @@
+#include "string_arena.hpp"
+
+namespace util {
+
+StringArena& StringArena::operator=(const StringArena& other) {
+    if (this != &other) {
+        // the lookup refers to its arena, so it has to be rebuilt.
+        this->text = other.text;
+        this->requested = other.requested;
+        this->lookup = decltype(this->lookup){other.lookup.size(), Hash{this}, Equal{this}};
+        this->lookup.insert(other.lookup.begin(), other.lookup.end());
+    }
+    return *this;
+}
+
+StringArena& StringArena::operator=(StringArena&& other) {
+    if (this != &other) {
+        this->text = std::move(other.text);
+        this->requested = other.requested;
+        this->lookup = decltype(this->lookup){other.lookup.size(), Hash{this}, Equal{this}};
+        this->lookup.insert(other.lookup.begin(), other.lookup.end());
+        other.clear();
+    }
+    return *this;
+}
+
+StringArena::Ref StringArena::intern(std::string_view str) {
+    this->requested += str.size();
+
+    if (const auto it = this->lookup.find(str); it != this->lookup.end()) {
+        return *it;
+    }
+
+    const Ref ref{static_cast<std::uint32_t>(this->text.size()), static_cast<std::uint32_t>(str.size())};
+    this->text.insert(this->text.end(), str.begin(), str.end());
+    this->lookup.emplace(ref);
+    return ref;
+}
+
+void StringArena::clear() {
+    this->text.clear();
+    this->lookup.clear();
+    this->requested = 0;
+}
+
+void StringArena::serialize(ByteWriter& writer) const {
+    writer.put_varint(this->text.size());
+    writer.put_bytes(this->text);
+
+    // the refs, so that interning carries on deduplicating after loading.
+    writer.put_varint(this->lookup.size());
+    for (const auto& ref : this->lookup) {
+        writer.put_varint(ref.offset);
+        writer.put_varint(ref.size);
+    }
+}
+
+bool StringArena::deserialize(ByteReader& reader) {
+    std::uint64_t size{};
+    if (!reader.get_varint(size) || size > reader.remaining()) {
+        return false;
+    }
+
+    this->clear();
+    this->text.resize(size);
+    if (!reader.get_bytes(this->text)) {
+        return false;
+    }
+
+    std::uint64_t count{};
+    if (!reader.get_varint(count) || count > reader.remaining()) {
+        return false;
+    }
+
+    this->lookup.reserve(count);
+    for (std::uint64_t i = 0; i < count; i++) {
+        std::uint64_t offset{}, length{};
+        if (!reader.get_varint(offset) || !reader.get_varint(length) || offset + length > this->text.size()) {
+            return false;
+        }
+        this->lookup.emplace(Ref{static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(length)});
+    }
+
+    this->requested = this->text.size();
+    return true;
+}
+
+} // namespace util
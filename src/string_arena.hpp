@@ -0,0 +1,71 @@
+#pragma once
+
+#include "byte_io.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+// append only storage for strings, each distinct string is stored once.
+// strings are referred to by offset so that the buffer can grow, and the
+// whole arena can be written out as is.
+class StringArena final {
+public:
+    struct Ref {
+        std::uint32_t offset{};
+        std::uint32_t size{};
+    };
+
+    StringArena() = default;
+    StringArena(const StringArena& other) { *this = other; }
+    StringArena(StringArena&& other) { *this = std::move(other); }
+    StringArena& operator=(const StringArena& other);
+    StringArena& operator=(StringArena&& other);
+
+    // returns the existing copy if the string was interned before.
+    Ref intern(std::string_view str);
+
+    [[nodiscard]]
+    std::string_view view(Ref ref) const noexcept {
+        return {reinterpret_cast<const char*>(this->text.data()) + ref.offset, ref.size};
+    }
+
+    void clear();
+
+    [[nodiscard]] auto stored_bytes() const noexcept { return this->text.size(); }
+    // what it would have taken without interning.
+    [[nodiscard]] auto requested_bytes() const noexcept { return this->requested; }
+    [[nodiscard]] auto unique_count() const noexcept { return this->lookup.size(); }
+
+    void serialize(ByteWriter& writer) const;
+    [[nodiscard]] bool deserialize(ByteReader& reader);
+
+private:
+    // hashes refs by the text they point at, so the set can be searched
+    // with a plain string_view.
+    struct Hash {
+        using is_transparent = void;
+        const StringArena* arena;
+        std::size_t operator()(Ref ref) const noexcept { return (*this)(this->arena->view(ref)); }
+        std::size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+    };
+
+    struct Equal {
+        using is_transparent = void;
+        const StringArena* arena;
+        template<typename A, typename B>
+        bool operator()(const A& a, const B& b) const noexcept { return this->get(a) == this->get(b); }
+        std::string_view get(Ref ref) const noexcept { return this->arena->view(ref); }
+        std::string_view get(std::string_view str) const noexcept { return str; }
+    };
+
+    std::vector<std::uint8_t> text{};
+    std::unordered_set<Ref, Hash, Equal> lookup{0, Hash{this}, Equal{this}};
+    std::uint64_t requested{};
+};
+
+} // namespace util
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "async.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stop_token>
+#include <utility>
+#include <type_traits>
+
+namespace util {
+
+// type erased reference to anything with post(Job&&, Priority),
+// eg a ThreadPool or a Dispatcher.
+class ExecutorRef final {
+public:
+    constexpr ExecutorRef() = default;
+
+    template<typename Executor>
+    requires (!std::is_same_v<std::remove_cv_t<Executor>, ExecutorRef>)
+    ExecutorRef(Executor& executor)
+    : self{&executor}
+    , post_fn{[](void* self, Job&& job, Priority priority) {
+        static_cast<Executor*>(self)->post(std::move(job), priority);
+    }} {}
+
+    void post(Job&& job, Priority priority) const {
+        this->post_fn(this->self, std::move(job), priority);
+    }
+
+    [[nodiscard]]
+    auto valid() const noexcept {
+        return this->self != nullptr;
+    }
+
+private:
+    void* self{nullptr};
+    void (*post_fn)(void*, Job&&, Priority){nullptr};
+};
+
+template<typename T>
+class Task;
+
+namespace detail {
+
+struct GetStopToken {};
+
+// state shared by every task promise.
+// a child task inherits the stop token and executor of whoever awaits it.
+struct PromiseBase {
+    std::coroutine_handle<> continuation{};
+    std::stop_token stop_token{};
+    ExecutorRef executor{};
+    Priority priority{Priority::Normal};
+    // called instead of resuming a continuation, used by spawn().
+    Job on_done{};
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept {
+            auto& promise = handle.promise();
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+            if (promise.on_done) {
+                // on_done may destroy the frame, so move it out first.
+                auto on_done = std::move(promise.on_done);
+                on_done();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() const noexcept { std::terminate(); }
+
+    auto await_transform(GetStopToken) const noexcept {
+        struct Awaiter {
+            std::stop_token stop_token;
+            bool await_ready() const noexcept { return true; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            std::stop_token await_resume() noexcept { return std::move(this->stop_token); }
+        };
+        return Awaiter{this->stop_token};
+    }
+
+    template<typename A>
+    A&& await_transform(A&& awaitable) const noexcept {
+        return std::forward<A>(awaitable);
+    }
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value{};
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& v) {
+        this->value.emplace(std::forward<U>(v));
+    }
+
+    T take() {
+        return std::move(*this->value);
+    }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void take() const noexcept {}
+};
+
+// runs the awaited task inline, resuming the parent once it finishes.
+template<typename T>
+struct TaskAwaiter {
+    std::coroutine_handle<Promise<T>> handle;
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> parent) noexcept {
+        auto& promise = this->handle.promise();
+        promise.continuation = parent;
+        promise.stop_token = parent.promise().stop_token;
+        promise.executor = parent.promise().executor;
+        promise.priority = parent.promise().priority;
+        return this->handle;
+    }
+
+    T await_resume() {
+        return this->handle.promise().take();
+    }
+};
+
+struct ScheduleOnAwaiter {
+    ExecutorRef executor;
+    Priority priority;
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename P>
+    void await_suspend(std::coroutine_handle<P> handle) const {
+        handle.promise().executor = this->executor;
+        handle.promise().priority = this->priority;
+        this->executor.post([handle]{ handle.resume(); }, this->priority);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct YieldAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template<typename P>
+    void await_suspend(std::coroutine_handle<P> handle) const {
+        const auto executor = handle.promise().executor;
+        executor.post([handle]{ handle.resume(); }, handle.promise().priority);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+template<typename T>
+struct FutureAwaiter {
+    AsyncFuture<T> future;
+
+    bool await_ready() const { return this->future.is_ready(); }
+
+    template<typename P>
+    void await_suspend(std::coroutine_handle<P> handle) {
+        // nothing in the frame may be touched once registered, as the
+        // task may already be running again on another thread.
+        this->future.on_complete([handle, executor = handle.promise().executor, priority = handle.promise().priority]{
+            executor.post([handle]{ handle.resume(); }, priority);
+        });
+    }
+
+    T await_resume() {
+        return this->future.get();
+    }
+};
+
+} // namespace detail
+
+// lazily started coroutine.
+// nothing runs until the task is either awaited by another task, which
+// runs it inline, or handed to spawn() which runs it on an executor.
+template<typename T>
+class [[nodiscard]] Task final {
+public:
+    using promise_type = detail::Promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    constexpr Task() = default;
+    explicit Task(handle_type h) noexcept : handle{h} {}
+    Task(Task&& other) noexcept : handle{std::exchange(other.handle, {})} {}
+    ~Task() {
+        if (this->handle) {
+            this->handle.destroy();
+        }
+    }
+
+    // disable copying
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (this->handle) {
+                this->handle.destroy();
+            }
+            this->handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto release() noexcept {
+        return std::exchange(this->handle, {});
+    }
+
+    auto operator co_await() && noexcept {
+        return detail::TaskAwaiter<T>{this->handle};
+    }
+
+private:
+    handle_type handle{};
+};
+
+namespace detail {
+
+template<typename T>
+inline Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+// co_await get_stop_token() inside a task to get the token it was spawned with.
+constexpr detail::GetStopToken get_stop_token() noexcept {
+    return {};
+}
+
+// resumes the task on another executor, eg to hop onto the main thread.
+template<typename Executor>
+auto schedule_on(Executor& executor, Priority priority = Priority::Normal) noexcept {
+    return detail::ScheduleOnAwaiter{ExecutorRef{executor}, priority};
+}
+
+// requeues the task on its executor so that other queued work can run.
+inline auto yield() noexcept {
+    return detail::YieldAwaiter{};
+}
+
+// suspends until the future is ready, then resumes on the task's executor.
+template<typename T>
+auto operator co_await(AsyncFuture<T>&& future) noexcept {
+    return detail::FutureAwaiter<T>{std::move(future)};
+}
+
+// runs the task on the executor, the returned future owns its stop source.
+template<typename Executor, typename T>
+auto spawn(Executor& executor, Task<T>&& task, Priority priority = Priority::Normal) -> AsyncFuture<T> {
+    std::stop_source source_token;
+    std::promise<T> promise;
+    auto future = promise.get_future();
+    auto completion = std::make_shared<detail::Completion>();
+
+    const auto handle = task.release();
+    auto& task_promise = handle.promise();
+    task_promise.stop_token = source_token.get_token();
+    task_promise.executor = ExecutorRef{executor};
+    task_promise.priority = priority;
+    task_promise.on_done = [handle, promise = std::move(promise), completion]() mutable {
+        detail::set_promise(promise, [&]() -> T {
+            return handle.promise().take();
+        });
+        handle.destroy();
+        completion->complete();
+    };
+
+    executor.post([handle]{ handle.resume(); }, priority);
+    return AsyncFuture<T>{std::move(future), std::move(source_token), std::move(completion)};
+}
+
+} // namespace util
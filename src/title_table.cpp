@@ -0,0 +1,95 @@
+#include "title_table.hpp"
+#include "collation.hpp"
+#include "radix_sort.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace tj {
+
+TitleTable::Row TitleTable::Add(AppEntry&& entry) {
+    const auto row = static_cast<Row>(this->ids.size());
+    this->ids.emplace_back(entry.id);
+    this->seconds.emplace_back(entry.playtime.totalSeconds());
+    this->images.emplace_back(entry.image);
+    this->flags.emplace_back((entry.own_image ? Flag_OwnImage : 0) | (entry.installed ? Flag_Installed : 0));
+    this->names.emplace_back(this->strings.intern(entry.name));
+    const auto author = this->strings.intern(entry.author);
+    this->authors.emplace_back(author);
+    // interning gives every distinct author the same ref. the offset alone
+    // isn't enough, an empty author shares its offset with whatever is
+    // interned next.
+    const auto author_key = static_cast<std::uint64_t>(author.offset) << 32 | author.size;
+    const auto [id, inserted] = this->author_lookup.try_emplace(author_key, static_cast<std::uint32_t>(this->author_refs.size()));
+    if (inserted) {
+        this->author_refs.emplace_back(author);
+    }
+    this->author_ids.emplace_back(*id);
+    this->versions.emplace_back(this->strings.intern(entry.display_version));
+
+    // keys are built once here rather than on every comparison.
+    const auto key = util::collation_key(entry.name);
+    std::array<std::uint8_t, 16> bytes{};
+    std::copy_n(key.begin(), std::min(key.size(), bytes.size()), bytes.begin());
+    SortPrefix prefix{};
+    for (std::size_t i = 0; i < 8; i++) {
+        prefix.hi = (prefix.hi << 8) | bytes[i];
+        prefix.lo = (prefix.lo << 8) | bytes[i + 8];
+    }
+    this->sort_prefixes.emplace_back(prefix);
+    this->sort_keys.emplace_back(this->keys.intern(key));
+    return row;
+}
+
+void TitleTable::Clear() {
+    this->ids.clear();
+    this->seconds.clear();
+    this->images.clear();
+    this->flags.clear();
+    this->names.clear();
+    this->authors.clear();
+    this->versions.clear();
+    this->strings.clear();
+    this->author_ids.clear();
+    this->author_refs.clear();
+    this->author_lookup.clear();
+    this->sort_prefixes.clear();
+    this->sort_keys.clear();
+    this->keys.clear();
+}
+
+bool TitleTable::NameLess(Row a, Row b) const {
+    const auto& prefix_a = this->sort_prefixes[a];
+    const auto& prefix_b = this->sort_prefixes[b];
+    if (prefix_a != prefix_b) {
+        return prefix_a < prefix_b;
+    }
+
+    const auto key_a = this->keys.view(this->sort_keys[a]);
+    const auto key_b = this->keys.view(this->sort_keys[b]);
+    if (key_a != key_b) {
+        return key_a < key_b;
+    }
+
+    return this->Name(a) < this->Name(b);
+}
+
+// radix sort keeps equal playtimes in row order, those runs are then put
+// in name order, which is cheap as there are only a few big ones.
+void SortByPlaytime(const TitleTable& titles, std::span<TitleTable::Row> rows, bool big_first) {
+    const auto seconds = titles.SecondsColumn();
+    util::radix_sort(rows, [seconds, big_first](auto row) {
+        return big_first ? ~seconds[row] : seconds[row];
+    });
+
+    const auto by_name = [&titles](auto a, auto b) { return titles.NameLess(a, b); };
+    for (auto first = rows.begin(); first != rows.end();) {
+        const auto last = std::find_if(first, rows.end(), [&](auto row) { return seconds[row] != seconds[*first]; });
+        if (last - first > 1) {
+            std::sort(first, last, by_name);
+        }
+        first = last;
+    }
+}
+
+} // namespace tj
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "playtime.hpp"
+#include "string_arena.hpp"
+#include "flat_map.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tj {
+
+using AppID = std::uint64_t;
+
+// a single title as the scan builds it, added to the table once done.
+struct AppEntry final {
+    std::string name;
+    std::string author;
+    std::string display_version;
+    Playtime playtime;
+    AppID id;
+    int image;
+    bool own_image{false};
+    bool installed{true};
+};
+
+// every scanned title, one column per field.
+// rows are only ever appended, sorting and filtering work on a permutation
+// of row indices so that only the columns a pass needs are touched.
+class TitleTable final {
+public:
+    using Row = std::uint32_t;
+
+    enum Flag : std::uint8_t {
+        Flag_OwnImage = 1 << 0,     // the image has to be freed
+        Flag_Installed = 1 << 1,
+    };
+
+    Row Add(AppEntry&& entry);
+    void Clear();
+
+    [[nodiscard]] std::size_t Size() const { return this->ids.size(); }
+    [[nodiscard]] bool Empty() const { return this->ids.empty(); }
+
+    [[nodiscard]] std::uint64_t Id(Row row) const { return this->ids[row]; }
+    [[nodiscard]] std::uint64_t Seconds(Row row) const { return this->seconds[row]; }
+    [[nodiscard]] int Image(Row row) const { return this->images[row]; }
+    [[nodiscard]] std::uint8_t Flags(Row row) const { return this->flags[row]; }
+    [[nodiscard]] bool Installed(Row row) const { return this->flags[row] & Flag_Installed; }
+    [[nodiscard]] std::string_view Name(Row row) const { return this->strings.view(this->names[row]); }
+    [[nodiscard]] std::string_view Author(Row row) const { return this->strings.view(this->authors[row]); }
+    [[nodiscard]] std::string_view DisplayVersion(Row row) const { return this->strings.view(this->versions[row]); }
+    [[nodiscard]] const util::StringArena& Strings() const { return this->strings; }
+
+    // authors are dictionary encoded, every distinct author gets a dense id.
+    [[nodiscard]] std::uint32_t AuthorId(Row row) const { return this->author_ids[row]; }
+    [[nodiscard]] std::size_t AuthorCount() const { return this->author_refs.size(); }
+    [[nodiscard]] std::string_view AuthorById(std::uint32_t id) const { return this->strings.view(this->author_refs[id]); }
+
+    // alphabetical order by collation key, see util::collation_key().
+    // ties, eg names that only differ in case or accents, fall back to the raw name.
+    [[nodiscard]] bool NameLess(Row a, Row b) const;
+    // the folded name the above compares, also what search matches against.
+    [[nodiscard]] std::string_view NameKey(Row row) const { return this->keys.view(this->sort_keys[row]); }
+
+    // whole columns, for passes over every row.
+    [[nodiscard]] std::span<const std::uint64_t> Ids() const { return this->ids; }
+    [[nodiscard]] std::span<const std::uint64_t> SecondsColumn() const { return this->seconds; }
+    [[nodiscard]] std::span<const std::uint8_t> FlagsColumn() const { return this->flags; }
+    [[nodiscard]] std::span<const std::uint32_t> AuthorIdColumn() const { return this->author_ids; }
+
+private:
+    std::vector<std::uint64_t> ids{};
+    std::vector<std::uint64_t> seconds{};
+    std::vector<int> images{};
+    std::vector<std::uint8_t> flags{};
+    // authors especially repeat a lot, so text is interned.
+    std::vector<util::StringArena::Ref> names{};
+    std::vector<util::StringArena::Ref> authors{};
+    std::vector<util::StringArena::Ref> versions{};
+    util::StringArena strings{};
+    std::vector<std::uint32_t> author_ids{};
+    std::vector<util::StringArena::Ref> author_refs{}; // per author id
+    util::FlatMap<std::uint64_t, std::uint32_t> author_lookup{}; // interned offset and size -> author id
+
+    // the first 16 bytes of each collation key loaded big endian, so that
+    // most name comparisons are two integer compares and never touch the text.
+    struct SortPrefix {
+        std::uint64_t hi, lo;
+        auto operator<=>(const SortPrefix&) const = default;
+    };
+
+    std::vector<SortPrefix> sort_prefixes{};
+    std::vector<util::StringArena::Ref> sort_keys{};
+    util::StringArena keys{};
+};
+
+// rows by playtime, most played first if big_first. equal playtimes are
+// in name order, see TitleTable::NameLess().
+void SortByPlaytime(const TitleTable& titles, std::span<TitleTable::Row> rows, bool big_first);
+
+} // namespace tj
@@ -0,0 +1,56 @@
+#include "user_matrix.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace tj {
+
+UserMatrix::UserMatrix(std::vector<User>&& users, std::vector<std::uint64_t>&& titles)
+: users{std::move(users)}
+, titles{std::move(titles)} {
+    this->cells.resize(this->titles.size() * this->ColumnCount());
+}
+
+void UserMatrix::Set(std::size_t title, std::size_t user, std::uint64_t seconds) {
+    this->cells[title * this->ColumnCount() + user] = static_cast<std::uint32_t>(std::min<std::uint64_t>(seconds, std::numeric_limits<std::uint32_t>::max()));
+}
+
+void UserMatrix::Finish() {
+    const auto columns = this->ColumnCount();
+    for (std::size_t title = 0; title < this->titles.size(); title++) {
+        const auto row = this->cells.begin() + title * columns;
+        const auto sum = std::accumulate(row, row + this->UserCount(), std::uint64_t{});
+        row[this->UserCount()] = static_cast<std::uint32_t>(std::min<std::uint64_t>(sum, std::numeric_limits<std::uint32_t>::max()));
+    }
+}
+
+std::uint64_t UserMatrix::Get(std::size_t title, std::size_t column) const {
+    return this->cells[title * this->ColumnCount() + column];
+}
+
+std::uint64_t UserMatrix::ColumnTotal(std::size_t column) const {
+    std::uint64_t total{};
+    for (std::size_t title = 0; title < this->titles.size(); title++) {
+        total += this->Get(title, column);
+    }
+    return total;
+}
+
+std::vector<std::uint32_t> UserMatrix::SortedBy(std::size_t column) const {
+    // pull the column out first so the sort compares contiguous keys
+    // instead of striding through the matrix.
+    std::vector<std::uint32_t> keys(this->titles.size());
+    for (std::size_t title = 0; title < keys.size(); title++) {
+        keys[title] = this->cells[title * this->ColumnCount() + column];
+    }
+
+    std::vector<std::uint32_t> order(this->titles.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&keys](auto a, auto b) {
+        return keys[a] > keys[b];
+    });
+    return order;
+}
+
+} // namespace tj
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <switch.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tj {
+
+// playtime of every title for every user on the console.
+// one row per title with a column per user, plus the combined time of all
+// users as the last column, so every column can be sorted the same way.
+class UserMatrix final {
+public:
+    struct User {
+        AccountUid uid;
+        std::string nickname;
+    };
+
+    UserMatrix() = default;
+    UserMatrix(std::vector<User>&& users, std::vector<std::uint64_t>&& titles);
+
+    void Set(std::size_t title, std::size_t user, std::uint64_t seconds);
+    // fills in the combined column, call once every user is set.
+    void Finish();
+
+    [[nodiscard]] std::uint64_t Get(std::size_t title, std::size_t column) const;
+    [[nodiscard]] std::uint64_t ColumnTotal(std::size_t column) const;
+    // title order by playtime of the column, most played first.
+    [[nodiscard]] std::vector<std::uint32_t> SortedBy(std::size_t column) const;
+
+    [[nodiscard]] const auto& Users() const { return this->users; }
+    [[nodiscard]] const auto& Titles() const { return this->titles; }
+    [[nodiscard]] std::size_t UserCount() const { return this->users.size(); }
+    // users + the combined column
+    [[nodiscard]] std::size_t ColumnCount() const { return this->users.size() + 1; }
+    [[nodiscard]] std::size_t CombinedColumn() const { return this->users.size(); }
+    [[nodiscard]] bool Empty() const { return this->titles.empty(); }
+
+private:
+    std::vector<User> users{};
+    std::vector<std::uint64_t> titles{};
+    std::vector<std::uint32_t> cells{};     // seconds, titles * ColumnCount()
+};
+
+} // namespace tj
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// counts the bytes live on the heap, to see what a structure costs.
+// replaces the global operator new / delete, include it from exactly one
+// file per program.
+namespace alloc_counter {
+
+inline std::atomic<std::size_t> live{};
+
+// the size is stored in front of every block so delete knows what to take off.
+constexpr std::size_t HEADER{alignof(std::max_align_t)};
+
+} // namespace alloc_counter
+
+void* operator new(std::size_t size) {
+    auto* block = static_cast<std::byte*>(std::malloc(size + alloc_counter::HEADER));
+    if (!block) {
+        std::abort();
+    }
+    *reinterpret_cast<std::size_t*>(block) = size;
+    alloc_counter::live.fetch_add(size, std::memory_order_relaxed);
+    return block + alloc_counter::HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    auto* block = static_cast<std::byte*>(ptr) - alloc_counter::HEADER;
+    alloc_counter::live.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
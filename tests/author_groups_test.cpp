@@ -0,0 +1,203 @@
+#include "author_groups.hpp"
+#include "flat_map.hpp"
+#include "title_table.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// AuthorGroups::Build() against a plain map aggregation, and LineAt()
+// against the lines written out one by one as groups are toggled.
+namespace {
+
+struct Expected {
+    std::uint64_t seconds{};
+    std::uint32_t count{};
+    std::uint32_t last_played{};
+    std::vector<tj::TitleTable::Row> rows{};
+};
+
+auto make_table(std::size_t count, std::mt19937_64& rng, std::vector<std::uint32_t>& last_played) -> tj::TitleTable {
+    // "" is a title without an author, "Idle" and "Quiet" are never played
+    // so they tie on seconds and fall back to the name.
+    static constexpr const char* AUTHORS[]{"Nintendo", "Sega", "Capcom", "", "Atlus", "Quiet", "Idle"};
+    std::uniform_int_distribution<std::size_t> author{0, std::size(AUTHORS) - 1};
+    std::uniform_int_distribution<std::uint64_t> seconds{0, 100000};
+    std::uniform_int_distribution<std::uint32_t> day{0, 1000};
+
+    tj::TitleTable table;
+    last_played.clear();
+    for (std::size_t i = 0; i < count; i++) {
+        tj::AppEntry entry{};
+        entry.name = "Game " + std::to_string(i);
+        entry.author = AUTHORS[author(rng)];
+        entry.id = i;
+        const auto quiet = entry.author == "Quiet" || entry.author == "Idle";
+        entry.playtime = Playtime::fromSeconds(quiet ? 0 : seconds(rng));
+        table.Add(std::move(entry));
+        last_played.emplace_back(quiet ? 0 : day(rng));
+    }
+    return table;
+}
+
+void check_build(const tj::TitleTable& table, const tj::AuthorGroups& groups, std::span<const tj::TitleTable::Row> rows, std::span<const std::uint32_t> last_played) {
+    std::map<std::uint32_t, Expected> expected;
+    for (const auto row : rows) {
+        auto& e = expected[table.AuthorId(row)];
+        e.seconds += table.Seconds(row);
+        e.count++;
+        if (row < last_played.size()) {
+            e.last_played = std::max(e.last_played, last_played[row]);
+        }
+        e.rows.emplace_back(row);
+    }
+
+    CHECK(groups.Groups().size() == expected.size());
+    CHECK(groups.Empty() == expected.empty());
+    for (std::size_t i = 0; i < groups.Groups().size(); i++) {
+        const auto& group = groups.Groups()[i];
+        const auto it = expected.find(group.author);
+        CHECK(it != expected.end());
+        if (it == expected.end()) {
+            continue;
+        }
+        CHECK(group.seconds == it->second.seconds);
+        CHECK(group.count == it->second.count);
+        CHECK(group.last_played == it->second.last_played);
+
+        // the rows of the group in the order they were given
+        const auto titles = groups.Titles(i);
+        CHECK(std::ranges::equal(titles, it->second.rows));
+        expected.erase(it);
+
+        if (i) {
+            // most played first, ties by author name
+            const auto& prev = groups.Groups()[i - 1];
+            CHECK(prev.seconds > group.seconds
+                || (prev.seconds == group.seconds && table.AuthorById(prev.author) < table.AuthorById(group.author)));
+        }
+    }
+    // each author once
+    CHECK(expected.empty());
+}
+
+// walks every line of the list as it should be and asks LineAt() for it.
+void check_lines(const tj::AuthorGroups& groups) {
+    std::size_t line{};
+    for (std::size_t group = 0; group < groups.Groups().size(); group++) {
+        CHECK(groups.HeaderLine(group) == line);
+        const auto header = groups.LineAt(line++);
+        CHECK(header.group == group && header.title == tj::AuthorGroups::HEADER);
+
+        if (groups.Expanded(group)) {
+            for (std::uint32_t title = 0; title < groups.Groups()[group].count; title++) {
+                const auto at = groups.LineAt(line++);
+                CHECK(at.group == group && at.title == title);
+            }
+        }
+    }
+    CHECK(groups.LineCount() == line);
+}
+
+void test_build_and_lines() {
+    std::mt19937_64 rng{50};
+    std::vector<std::uint32_t> last_played;
+    for (const std::size_t count : {1, 2, 10, 500, 5000}) {
+        const auto table = make_table(count, rng, last_played);
+
+        // every other row and backwards, so the groups only see those
+        std::vector<tj::TitleTable::Row> rows;
+        for (std::size_t i = 0; i < count; i += 2) {
+            rows.emplace_back(static_cast<tj::TitleTable::Row>(count - 1 - i));
+        }
+
+        auto groups = tj::AuthorGroups::Build(table, rows, last_played);
+        check_build(table, groups, rows, last_played);
+
+        // all collapsed to start with, a header per group
+        CHECK(groups.LineCount() == groups.Groups().size());
+        for (std::size_t group = 0; group < groups.Groups().size(); group++) {
+            CHECK(!groups.Expanded(group));
+        }
+        check_lines(groups);
+
+        if (groups.Empty()) {
+            continue;
+        }
+
+        // first, last and random groups, each toggle checked against the full walk
+        const auto last = groups.Groups().size() - 1;
+        std::uniform_int_distribution<std::size_t> pick{0, last};
+        std::vector<std::size_t> toggles{0, last, last, 0};
+        for (int i = 0; i < 20; i++) {
+            toggles.emplace_back(pick(rng));
+        }
+        for (const auto group : toggles) {
+            const auto was = groups.Expanded(group);
+            const auto before = groups.LineCount();
+            groups.Toggle(group);
+            CHECK(groups.Expanded(group) == !was);
+            const std::size_t titles = groups.Groups()[group].count;
+            CHECK(groups.LineCount() == (was ? before - titles : before + titles));
+            check_lines(groups);
+        }
+
+        // everything expanded, the lines are every header plus every row
+        for (std::size_t group = 0; group < groups.Groups().size(); group++) {
+            if (!groups.Expanded(group)) {
+                groups.Toggle(group);
+            }
+        }
+        CHECK(groups.LineCount() == groups.Groups().size() + rows.size());
+        check_lines(groups);
+    }
+}
+
+void test_edges() {
+    std::mt19937_64 rng{500};
+    std::vector<std::uint32_t> last_played;
+    const auto table = make_table(100, rng, last_played);
+
+    const auto empty = tj::AuthorGroups::Build(table, {}, last_played);
+    CHECK(empty.Empty());
+    CHECK(empty.LineCount() == 0);
+
+    // no last played for the later rows, they count as never played
+    std::vector<tj::TitleTable::Row> rows(100);
+    for (std::size_t i = 0; i < rows.size(); i++) {
+        rows[i] = static_cast<tj::TitleTable::Row>(i);
+    }
+    const auto short_days = std::span{last_played}.first(30);
+    const auto groups = tj::AuthorGroups::Build(table, rows, short_days);
+    check_build(table, groups, rows, short_days);
+    check_lines(groups);
+}
+
+void test_flat_map() {
+    util::FlatMap<std::uint32_t, std::uint32_t> map;
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        CHECK(map.try_emplace(i * 7, i).second);
+    }
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        CHECK(map.find(i * 7) && *map.find(i * 7) == i);
+        CHECK(!map.find(i * 7 + 1));
+    }
+    const auto [value, inserted] = map.try_emplace(7, 0);
+    CHECK(!inserted && *value == 1);
+    CHECK(map.size() == 10000);
+}
+
+} // namespace
+
+int main() {
+    test_build_and_lines();
+    test_edges();
+    test_flat_map();
+    return test::result();
+}
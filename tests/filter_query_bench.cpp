@@ -0,0 +1,85 @@
+#include "filter_query.hpp"
+#include "collation.hpp"
+#include "title_table.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// a compiled filter over 100k rows, against the same filter written out by
+// hand as one test per row, folding the author each time like a plain
+// loop over the entries would.
+namespace {
+
+constexpr std::size_t ROWS{100'000};
+constexpr std::uint32_t TODAY{200};
+
+void bench() {
+    static constexpr const char* AUTHORS[]{"Nintendo", "Sega", "Capcom", "Square Enix", "Atlus", "Bandai Namco"};
+    std::mt19937_64 rng{48};
+    std::uniform_int_distribution<std::size_t> author{0, std::size(AUTHORS) - 1};
+    std::uniform_int_distribution<std::uint64_t> seconds{0, 100 * 3600};
+    std::uniform_int_distribution<std::uint32_t> day{0, TODAY};
+
+    tj::TitleTable table;
+    std::vector<std::uint32_t> last_played(ROWS);
+    for (std::size_t i = 0; i < ROWS; i++) {
+        tj::AppEntry entry{};
+        entry.name = "Game " + std::to_string(i);
+        entry.author = AUTHORS[author(rng)];
+        entry.id = i;
+        entry.playtime = Playtime::fromSeconds(seconds(rng));
+        entry.installed = rng() % 2;
+        table.Add(std::move(entry));
+        last_played[i] = day(rng);
+    }
+    const tj::FilterColumns columns{table, last_played, TODAY};
+
+    static constexpr const char* QUERY{"playtime > 10h and author = \"Nintendo\" and played in last 30 days or uninstalled"};
+    std::string error;
+    const auto compile_ms = test::best_ms(100, [&]{
+        test::keep(tj::FilterQuery::Compile(QUERY, error));
+    });
+    const auto query = tj::FilterQuery::Compile(QUERY, error);
+    CHECK(query.has_value());
+    if (!query) {
+        return;
+    }
+
+    std::vector<std::uint8_t> mask;
+    const auto query_ms = test::best_ms(10, [&]{
+        mask = query->Evaluate(columns);
+    });
+
+    std::vector<std::uint8_t> expected(ROWS);
+    const auto nintendo = util::collation_key("Nintendo");
+    const auto by_hand_ms = test::best_ms(10, [&]{
+        for (tj::TitleTable::Row row = 0; row < ROWS; row++) {
+            expected[row] = (table.Seconds(row) > 10 * 3600
+                && util::collation_key(table.Author(row)) == nintendo
+                && last_played[row] >= TODAY - 30 + 1)
+                || !table.Installed(row);
+        }
+    });
+    CHECK(mask == expected);
+
+    std::size_t passed{};
+    for (const auto pass : mask) {
+        passed += pass;
+    }
+
+    std::printf("%zu rows, %zu pass: %s\n", ROWS, passed, QUERY);
+    std::printf("  compile        %8.4f ms\n", compile_ms);
+    std::printf("  evaluate       %8.2f ms\n", query_ms);
+    std::printf("  row by row     %8.2f ms\n", by_hand_ms);
+}
+
+} // namespace
+
+int main() {
+    bench();
+    return test::result();
+}
@@ -0,0 +1,105 @@
+#include "filter_query.hpp"
+#include "title_table.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// FilterQuery against hand worked masks over four titles, and every way
+// the parser can refuse a filter, with the message the user gets.
+namespace {
+
+auto make_table() -> tj::TitleTable {
+    tj::TitleTable table;
+    const auto add = [&](const char* name, const char* author, std::uint64_t seconds, bool installed) {
+        tj::AppEntry entry{};
+        entry.name = name;
+        entry.author = author;
+        entry.id = table.Size();
+        entry.playtime = Playtime::fromSeconds(seconds);
+        entry.installed = installed;
+        table.Add(std::move(entry));
+    };
+    add("The Legend of Zelda", "Nintendo", 20 * 3600, true);
+    add("Pokémon Violet", "The Pokémon Company", 5 * 3600, true);
+    add("Super Mario Odyssey", "NINTENDO", 50 * 3600, false);
+    add("Hades", "Supergiant", 30 * 60, true);
+    return table;
+}
+
+// the mask as a string of 0 and 1, or the error.
+auto run(const tj::FilterColumns& columns, std::string_view text) -> std::string {
+    std::string error;
+    const auto query = tj::FilterQuery::Compile(text, error);
+    if (!query) {
+        CHECK(!error.empty());
+        return "error: " + error;
+    }
+    CHECK(error.empty());
+
+    std::string mask;
+    for (const auto pass : query->Evaluate(columns)) {
+        mask += pass ? '1' : '0';
+    }
+    return mask;
+}
+
+void test_masks(const tj::FilterColumns& columns) {
+    CHECK(run(columns, "playtime > 10h and author = \"Nintendo\"") == "1010");
+    CHECK(run(columns, "playtime >= 30m") == "1111");
+    CHECK(run(columns, "playtime < 1800s") == "0000");
+    CHECK(run(columns, "playtime <= 1.5") == "0001");
+    CHECK(run(columns, "playtime == 5h") == "0100");
+    CHECK(run(columns, "played in last 30 days") == "1011");
+    CHECK(run(columns, "played in last 6 days") == "1010");
+    CHECK(run(columns, "played in last 1 day") == "1000");
+    CHECK(run(columns, "not played in last 6 days") == "0101");
+    CHECK(run(columns, "uninstalled or name ~ pokemon") == "0110");
+    CHECK(run(columns, "(installed and playtime < 6h) | author ~ nin") == "1111");
+    CHECK(run(columns, "!(installed) & ! !uninstalled") == "0010");
+    CHECK(run(columns, "author != nintendo") == "0101");
+    CHECK(run(columns, "NAME = hades") == "0001");
+    CHECK(run(columns, "name ~ \"of") == "1000");
+    // and binds tighter than or
+    CHECK(run(columns, "uninstalled or installed and playtime > 10h") == "1010");
+    CHECK(run(columns, "(uninstalled or installed) and playtime > 10h") == "1010");
+    CHECK(run(columns, "uninstalled and playtime > 10h or name = hades") == "0011");
+}
+
+void test_errors(const tj::FilterColumns& columns) {
+    CHECK(run(columns, "") == "error: empty filter at 1");
+    CHECK(run(columns, "   ") == "error: empty filter at 4");
+    CHECK(run(columns, "playtime >") == "error: expected a duration, eg 10h or 30m at 11");
+    CHECK(run(columns, "playtime > ") == "error: expected a duration, eg 10h or 30m at 12");
+    CHECK(run(columns, "playtime 10h") == "error: expected a comparison at 10");
+    CHECK(run(columns, "playtime ~ 10h") == "error: expected a comparison at 10");
+    CHECK(run(columns, "playtime > 10x") == "error: expected a duration, eg 10h or 30m at 12");
+    CHECK(run(columns, "playtime > hades") == "error: expected a duration, eg 10h or 30m at 12");
+    CHECK(run(columns, "name > hades") == "error: expected =, != or ~ at 6");
+    CHECK(run(columns, "name =") == "error: expected text at 7");
+    CHECK(run(columns, "played last 6 days") == "error: expected 'in last' at 8");
+    CHECK(run(columns, "played in last days") == "error: expected a number of days at 16");
+    CHECK(run(columns, "colour = red") == "error: unknown field 'colour' at 1");
+    CHECK(run(columns, "(installed") == "error: expected ')' at 11");
+    CHECK(run(columns, "((installed) or (uninstalled)") == "error: expected ')' at 30");
+    CHECK(run(columns, "installed)") == "error: unexpected ')' at 10");
+    CHECK(run(columns, "()") == "error: expected a field at 2");
+    CHECK(run(columns, "installed installed") == "error: unexpected 'installed' at 11");
+    CHECK(run(columns, "installed and") == "error: expected a field at 14");
+    CHECK(run(columns, "not") == "error: expected a field at 4");
+    CHECK(run(columns, "or installed") == "error: unknown field 'or' at 1");
+}
+
+} // namespace
+
+int main() {
+    const auto table = make_table();
+    const std::vector<std::uint32_t> last_played{100, 0, 95, 71};
+    const tj::FilterColumns columns{table, last_played, 100};
+
+    test_masks(columns);
+    test_errors(columns);
+    return test::result();
+}
@@ -0,0 +1,87 @@
+#include "parallel.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// sorting and filtering a million rows, with pools of 1 to every core
+// against doing it all on this thread. rows are compared through a key
+// lookup like the title table does.
+namespace {
+
+constexpr std::size_t ROWS{1'000'000};
+
+template<typename Setup, typename Fn>
+double timed_ms(Setup&& setup, Fn&& fn) {
+    auto best = 1e300;
+    for (int i = 0; i < 5; i++) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double, std::milli> took{std::chrono::steady_clock::now() - start};
+        best = std::min(best, took.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937_64 rng{46};
+    std::vector<std::uint64_t> keys(ROWS);
+    std::vector<std::uint8_t> flags(ROWS);
+    for (std::size_t i = 0; i < ROWS; i++) {
+        keys[i] = rng();
+        flags[i] = rng() % 10 != 0;
+    }
+
+    std::vector<std::uint32_t> input(ROWS), rows;
+    for (std::size_t i = 0; i < ROWS; i++) {
+        input[i] = static_cast<std::uint32_t>(i);
+    }
+    const auto reset = [&]{ rows = input; };
+    const auto by_key = [&keys](auto a, auto b) { return keys[a] < keys[b]; };
+    const auto shown = [&flags](auto row) { return flags[row] != 0; };
+
+    std::vector<std::uint32_t> expected;
+    const auto sort_ms = timed_ms(reset, [&]{ std::ranges::sort(rows, by_key); });
+    expected = rows;
+    std::size_t expected_shown{};
+    const auto filter_ms = timed_ms([]{}, [&]{
+        std::vector<std::uint32_t> out;
+        for (std::uint32_t i = 0; i < ROWS; i++) {
+            if (shown(i)) {
+                out.push_back(i);
+            }
+        }
+        expected_shown = out.size();
+    });
+
+    std::printf("%zu rows, %u cores\n", ROWS, std::thread::hardware_concurrency());
+    std::printf("  %-18s sort %8.2f ms          filter %6.2f ms\n", "this thread only", sort_ms, filter_ms);
+
+    const auto cores = std::max(2u, std::thread::hardware_concurrency());
+    for (std::size_t workers = 1; workers < cores; workers++) {
+        util::ThreadPool pool{workers};
+        const auto par_sort_ms = timed_ms(reset, [&]{ util::parallel_sort(pool, std::span{rows}, by_key); });
+        CHECK(rows == expected); // keys are unique, so the order is too
+
+        std::size_t par_shown{};
+        const auto par_filter_ms = timed_ms([]{}, [&]{
+            par_shown = util::parallel_filter<std::uint32_t>(pool, ROWS, shown).size();
+        });
+        CHECK(par_shown == expected_shown);
+
+        const auto name = std::to_string(workers) + " worker(s) + this";
+        std::printf("  %-18s sort %8.2f ms (%.2fx) filter %6.2f ms (%.2fx)\n", name.c_str(),
+            par_sort_ms, sort_ms / par_sort_ms, par_filter_ms, filter_ms / par_filter_ms);
+    }
+
+    return test::result();
+}
@@ -0,0 +1,97 @@
+#include "parallel.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// parallel_sort() against std::stable_sort and parallel_filter() against a
+// plain loop, over pool sizes that do and don't divide the work evenly,
+// sizes either side of PARALLEL_MIN, and from inside a worker of the pool.
+// run under thread sanitizer.
+namespace {
+
+using Item = std::pair<std::uint32_t, std::uint32_t>; // key, where it started
+
+constexpr auto by_key = [](const Item& a, const Item& b) { return a.first < b.first; };
+
+void check_sort(util::ThreadPool& pool, std::vector<Item> items) {
+    auto expected = items;
+    std::ranges::stable_sort(expected, by_key);
+    util::parallel_sort(pool, std::span{items}, by_key);
+
+    // equal keys may come out in any order, but the same keys in the same
+    // places and nothing lost or doubled.
+    bool keys_match = items.size() == expected.size();
+    for (std::size_t i = 0; keys_match && i < items.size(); i++) {
+        keys_match = items[i].first == expected[i].first;
+    }
+    CHECK(keys_match);
+    std::ranges::sort(items);
+    std::ranges::sort(expected);
+    CHECK(items == expected);
+}
+
+void test_sort_and_filter() {
+    std::mt19937 rng{46};
+    for (const std::size_t threads : {1, 2, 3, 4, 7}) {
+        util::ThreadPool pool{threads};
+        for (const std::size_t size : {std::size_t{0}, std::size_t{5}, util::PARALLEL_MIN - 1, util::PARALLEL_MIN, std::size_t{50001}, std::size_t{100000}}) {
+            std::vector<Item> items(size);
+            for (std::uint32_t i = 0; i < size; i++) {
+                items[i] = {static_cast<std::uint32_t>(rng() % 1000), i};
+            }
+            check_sort(pool, items);
+
+            // all equal, then already sorted
+            for (auto& item : items) {
+                item.first = 7;
+            }
+            check_sort(pool, items);
+            for (std::uint32_t i = 0; i < size; i++) {
+                items[i].first = i;
+            }
+            check_sort(pool, items);
+
+            const auto filtered = util::parallel_filter<std::uint32_t>(pool, size, [](auto i) { return i % 3 == 0; });
+            bool filter_ok = filtered.size() == (size + 2) / 3;
+            for (std::size_t i = 0; filter_ok && i < filtered.size(); i++) {
+                filter_ok = filtered[i] == i * 3;
+            }
+            CHECK(filter_ok);
+        }
+    }
+}
+
+// the calling thread joins in, so a worker waiting on its own pool can't deadlock.
+void test_nested() {
+    util::ThreadPool pool{2};
+    auto future = pool.submit(util::Priority::Normal, [&pool]{
+        std::mt19937 rng{460};
+        std::vector<std::uint32_t> values(200000);
+        for (auto& value : values) {
+            value = rng();
+        }
+        util::parallel_sort(pool, std::span{values});
+        return std::ranges::is_sorted(values);
+    });
+    CHECK(future.get());
+}
+
+void test_parallel_for() {
+    util::ThreadPool pool{3};
+    std::vector<std::uint32_t> hits(100000);
+    util::parallel_for(pool, hits.size(), [&hits](std::size_t i) { hits[i]++; });
+    CHECK(std::ranges::all_of(hits, [](auto n) { return n == 1; }));
+}
+
+} // namespace
+
+int main() {
+    test_sort_and_filter();
+    test_nested();
+    test_parallel_for();
+    return test::result();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <switch.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// in-memory pdm play event log for the tests / benchmarks of the event
+// folding. defines the libnx functions play_events.cpp calls, include it
+// from exactly one file per program.
+namespace pdm_mock {
+
+inline std::vector<PdmPlayEvent> events{};
+// index of events[0], goes up when old events are rotated out.
+inline s32 first_index{};
+inline std::uint64_t query_calls{};
+// stands in for the cost of an ipc round trip.
+inline std::chrono::nanoseconds ipc_cost{};
+
+inline void reset() {
+    events.clear();
+    first_index = 0;
+    query_calls = 0;
+}
+
+inline void ipc() {
+    query_calls++;
+    const auto until = std::chrono::steady_clock::now() + ipc_cost;
+    while (ipc_cost.count() && std::chrono::steady_clock::now() < until) {
+    }
+}
+
+inline void split_u64(std::uint64_t value, u32 (&out)[2]) {
+    out[0] = static_cast<u32>(value >> 32);
+    out[1] = static_cast<u32>(value);
+}
+
+inline PdmPlayEvent make(u8 type, std::uint64_t clock, std::uint64_t steady) {
+    PdmPlayEvent e{};
+    e.play_event_type = type;
+    e.timestamp_user = clock;
+    e.timestamp_network = clock;
+    e.timestamp_steady = steady;
+    return e;
+}
+
+inline void applet(std::uint64_t id, PdmAppletEventType type, std::uint64_t clock, std::uint64_t steady, PdmPlayLogPolicy policy = PdmPlayLogPolicy_All) {
+    auto e = make(PdmPlayEventType_Applet, clock, steady);
+    split_u64(id, e.event_data.applet.program_id);
+    e.event_data.applet.event_type = type;
+    e.event_data.applet.log_policy = policy;
+    events.emplace_back(e);
+}
+
+inline void account(AccountUid uid, std::uint64_t id, u8 type, std::uint64_t clock, std::uint64_t steady) {
+    auto e = make(PdmPlayEventType_Account, clock, steady);
+    auto& data = e.event_data.account;
+    data.uid[0] = static_cast<u32>(uid.uid[0] >> 32);
+    data.uid[1] = static_cast<u32>(uid.uid[0]);
+    data.uid[2] = static_cast<u32>(uid.uid[1] >> 32);
+    data.uid[3] = static_cast<u32>(uid.uid[1]);
+    split_u64(id, data.unk_x10.application_info.application_id);
+    data.type = type;
+    events.emplace_back(e);
+}
+
+inline void power(std::uint64_t clock, std::uint64_t steady) {
+    events.emplace_back(make(PdmPlayEventType_PowerStateChange, clock, steady));
+}
+
+// drops the oldest events, as the console does once its log is full.
+inline void rotate(std::size_t count) {
+    events.erase(events.begin(), events.begin() + count);
+    first_index += static_cast<s32>(count);
+}
+
+} // namespace pdm_mock
+
+Result pdmqryQueryPlayEvent(s32 entry_index, PdmPlayEvent* out, s32 count, s32* total_out) {
+    pdm_mock::ipc();
+    const auto end = pdm_mock::first_index + static_cast<s32>(pdm_mock::events.size());
+    *total_out = 0;
+    for (auto i = std::max(entry_index, pdm_mock::first_index); i < end && *total_out < count; i++) {
+        out[(*total_out)++] = pdm_mock::events[i - pdm_mock::first_index];
+    }
+    return 0;
+}
+
+Result pdmqryGetAvailablePlayEventRange(s32* total_entries, s32* start_entry_index, s32* end_entry_index) {
+    pdm_mock::ipc();
+    *total_entries = static_cast<s32>(pdm_mock::events.size());
+    *start_entry_index = pdm_mock::first_index;
+    *end_entry_index = pdm_mock::first_index + static_cast<s32>(pdm_mock::events.size()) - 1;
+    return 0;
+}
+
+// the console's clock and timezone aren't used by the folding itself.
+Result timeGetCurrentTime(TimeType, u64* timestamp) {
+    *timestamp = 0;
+    return 0;
+}
+
+Result timeToCalendarTimeWithMyRule(u64, TimeCalendarTime* caltime, TimeCalendarAdditionalInfo* info) {
+    *caltime = {};
+    *info = {};
+    return 0;
+}
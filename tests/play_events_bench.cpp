@@ -0,0 +1,131 @@
+#include "play_events.hpp"
+#include "pdm_mock.hpp"
+#include "test.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stop_token>
+#include <unordered_map>
+#include <vector>
+
+// one ipc call per installed title (pdm sums up each title itself) against
+// reading the whole event log in batches and folding it here, and against
+// carrying on from a cached engine with only the newest events.
+// pdm's real ipc cost isn't known on the host, so it's spun for a few
+// made up round trip times.
+namespace {
+
+constexpr AccountUid USER{{0x1111222233334444, 0x5555666677778888}};
+constexpr std::uint64_t TITLES{300};
+constexpr int SESSIONS{12000}; // ~5 events each, a well used console's log
+constexpr int NEW_SESSIONS{20};
+constexpr std::uint64_t DAY{tj::PlayHistory::SECONDS_PER_DAY};
+
+std::unordered_map<std::uint64_t, std::uint64_t> statistics{};
+
+auto title_id(std::uint64_t index) -> std::uint64_t {
+    return 0x0100000000010000 + index * 0x1000;
+}
+
+void make_log(int sessions) {
+    std::mt19937_64 rng{34};
+    std::geometric_distribution<std::uint64_t> title{0.03};
+    std::uniform_int_distribution<std::uint64_t> length{60, 3 * 3600};
+    auto t = 18000 * DAY;
+    for (int i = 0; i < sessions; i++) {
+        const auto id = title_id(title(rng) % TITLES);
+        const auto seconds = length(rng);
+        pdm_mock::applet(id, PdmAppletEventType_Launch, t, t);
+        pdm_mock::account(USER, id, 0, t, t);
+        pdm_mock::applet(id, PdmAppletEventType_InFocus, t, t);
+        pdm_mock::account(USER, id, 1, t + seconds, t + seconds);
+        pdm_mock::applet(id, PdmAppletEventType_Exit, t + seconds, t + seconds);
+        statistics[id] += seconds;
+        t += seconds + 3600;
+    }
+}
+
+} // namespace
+
+// the service has the totals at hand, only the round trip costs anything.
+Result pdmqryQueryPlayStatisticsByApplicationIdAndUserAccountId(u64 application_id, AccountUid, bool, PdmPlayStatistics* stats) {
+    pdm_mock::ipc();
+    *stats = {};
+    stats->application_id = application_id;
+    if (const auto it = statistics.find(application_id); it != statistics.end()) {
+        stats->playtime = it->second * 1'000'000'000;
+    }
+    return 0;
+}
+
+int main() {
+    make_log(SESSIONS);
+    std::printf("%zu events, %llu titles installed, %d new sessions since the cache was saved\n",
+        pdm_mock::events.size(), static_cast<unsigned long long>(TITLES), NEW_SESSIONS);
+
+    // the cache as the last launch left it
+    const auto all_events = pdm_mock::events;
+    pdm_mock::events.resize(all_events.size() - NEW_SESSIONS * 5);
+    tj::PlaytimeEngine cached{USER, 0};
+    tj::PlayCursor cached_cursor{};
+    CHECK(R_SUCCEEDED(tj::FoldPlayEvents(cached, cached_cursor, std::stop_token{})));
+    std::vector<std::uint8_t> saved;
+    cached.Serialize(saved);
+    pdm_mock::events = all_events;
+
+    for (const auto cost : {0, 20, 100}) {
+        pdm_mock::ipc_cost = std::chrono::microseconds{cost};
+        std::uint64_t per_title_total{}, fold_total{}, cached_total{};
+        std::uint64_t per_title_calls{}, fold_calls{}, cached_calls{};
+
+        const auto per_title_ms = test::best_ms(3, [&]{
+            pdm_mock::query_calls = 0;
+            per_title_total = 0;
+            for (std::uint64_t i = 0; i < TITLES; i++) {
+                PdmPlayStatistics stats{};
+                if (R_SUCCEEDED(pdmqryQueryPlayStatisticsByApplicationIdAndUserAccountId(title_id(i), USER, false, &stats))) {
+                    per_title_total += stats.playtime / 1'000'000'000;
+                }
+            }
+            per_title_calls = pdm_mock::query_calls;
+        });
+
+        const auto fold_ms = test::best_ms(3, [&]{
+            pdm_mock::query_calls = 0;
+            tj::PlaytimeEngine engine{USER, 0};
+            tj::PlayCursor cursor{};
+            CHECK(tj::IsCursorValid(cursor));
+            CHECK(R_SUCCEEDED(tj::FoldPlayEvents(engine, cursor, std::stop_token{})));
+            fold_total = 0;
+            for (std::uint64_t i = 0; i < TITLES; i++) {
+                fold_total += engine.Seconds(title_id(i));
+            }
+            fold_calls = pdm_mock::query_calls;
+        });
+
+        const auto cached_ms = test::best_ms(3, [&]{
+            pdm_mock::query_calls = 0;
+            tj::PlaytimeEngine engine{USER, 0};
+            auto cursor = cached_cursor;
+            CHECK(engine.Deserialize(saved));
+            CHECK(tj::IsCursorValid(cursor));
+            CHECK(R_SUCCEEDED(tj::FoldPlayEvents(engine, cursor, std::stop_token{})));
+            cached_total = 0;
+            for (std::uint64_t i = 0; i < TITLES; i++) {
+                cached_total += engine.Seconds(title_id(i));
+            }
+            cached_calls = pdm_mock::query_calls;
+        });
+
+        CHECK(per_title_total == fold_total);
+        CHECK(per_title_total == cached_total);
+        std::printf("  %3d us per ipc: per title %7.2f ms (%3llu calls), fold log %7.2f ms (%2llu calls), from cache %6.2f ms (%llu calls)\n",
+            cost, per_title_ms, static_cast<unsigned long long>(per_title_calls),
+            fold_ms, static_cast<unsigned long long>(fold_calls),
+            cached_ms, static_cast<unsigned long long>(cached_calls));
+    }
+
+    return test::result();
+}
@@ -0,0 +1,251 @@
+#include "play_events.hpp"
+#include "pdm_mock.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <stop_token>
+#include <vector>
+
+// the event folding against a made up pdm log: what counts as played,
+// what doesn't, and that folding in pieces gives the same as all at once.
+namespace {
+
+constexpr AccountUid USER{{0x1111222233334444, 0x5555666677778888}};
+constexpr AccountUid OTHER{{0x1, 0x2}};
+constexpr std::uint64_t GAME{0x0100000000010000};
+constexpr std::uint64_t GAME2{0x0100000000020000};
+constexpr std::uint64_t DAY{tj::PlayHistory::SECONDS_PER_DAY};
+constexpr std::uint64_t T0{19000 * DAY + 10 * 3600}; // 10am
+
+auto fold(AccountUid uid = USER, std::int64_t utc_offset = 0) -> tj::PlaytimeEngine {
+    tj::PlaytimeEngine engine{uid, utc_offset};
+    tj::PlayCursor cursor{};
+    CHECK(R_SUCCEEDED(tj::FoldPlayEvents(engine, cursor, std::stop_token{})));
+    CHECK(cursor.next_index == pdm_mock::first_index + static_cast<s32>(pdm_mock::events.size()));
+    return engine;
+}
+
+// steady and user clock tick together unless a test says otherwise.
+void open_and_focus(AccountUid uid, std::uint64_t id, std::uint64_t t) {
+    pdm_mock::applet(id, PdmAppletEventType_Launch, t, t);
+    pdm_mock::account(uid, id, 0, t, t);
+    pdm_mock::applet(id, PdmAppletEventType_InFocus, t, t);
+}
+
+void test_focus_and_exit() {
+    pdm_mock::reset();
+    open_and_focus(USER, GAME, T0);
+    pdm_mock::applet(GAME, PdmAppletEventType_OutOfFocus, T0 + 100, T0 + 100);
+    // time out of focus (home menu) doesn't count
+    pdm_mock::applet(GAME, PdmAppletEventType_InFocus, T0 + 400, T0 + 400);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit, T0 + 450, T0 + 450);
+    // nor does anything after exiting
+    pdm_mock::applet(GAME, PdmAppletEventType_OutOfFocus4, T0 + 900, T0 + 900);
+
+    const auto engine = fold();
+    CHECK(engine.Seconds(GAME) == 150);
+    CHECK(engine.Seconds(GAME2) == 0);
+    CHECK(engine.EventCount() == pdm_mock::events.size() - 1); // launch isn't kept
+}
+
+void test_account_open_close() {
+    pdm_mock::reset();
+    open_and_focus(USER, GAME, T0);
+    pdm_mock::account(USER, GAME, 1, T0 + 60, T0 + 60);
+    // still in focus, but the user closed it
+    pdm_mock::account(USER, GAME, 0, T0 + 200, T0 + 200);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit5, T0 + 230, T0 + 230);
+
+    CHECK(fold().Seconds(GAME) == 90);
+    // the other user never opened it
+    CHECK(fold(OTHER).Seconds(GAME) == 0);
+}
+
+void test_other_users() {
+    pdm_mock::reset();
+    open_and_focus(OTHER, GAME, T0);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit, T0 + 500, T0 + 500);
+    open_and_focus(USER, GAME, T0 + 1000);
+    // someone else's account events don't touch our session
+    pdm_mock::account(OTHER, GAME, 1, T0 + 1010, T0 + 1010);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit6, T0 + 1100, T0 + 1100);
+
+    CHECK(fold(USER).Seconds(GAME) == 100);
+    CHECK(fold(OTHER).Seconds(GAME) == 500);
+}
+
+// types 2 and 3 are the network service account, not the user leaving.
+void test_network_account_events() {
+    pdm_mock::reset();
+    open_and_focus(USER, GAME, T0);
+    pdm_mock::account(USER, GAME, 2, T0 + 10, T0 + 10);
+    pdm_mock::account(USER, GAME, 3, T0 + 20, T0 + 20);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit, T0 + 300, T0 + 300);
+
+    CHECK(fold().Seconds(GAME) == 300);
+}
+
+void test_suspend() {
+    pdm_mock::reset();
+    open_and_focus(USER, GAME, T0);
+    // sleep at +50, the steady clock stops while asleep and the user
+    // clock doesn't. pdm logs InFocus again once back.
+    pdm_mock::power(T0 + 50, T0 + 50);
+    pdm_mock::power(T0 + 5000, T0 + 51);
+    pdm_mock::applet(GAME, PdmAppletEventType_InFocus, T0 + 5001, T0 + 52);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit, T0 + 5061, T0 + 112);
+
+    CHECK(fold().Seconds(GAME) == 110);
+}
+
+void test_log_policy() {
+    pdm_mock::reset();
+    pdm_mock::account(USER, GAME, 0, T0, T0);
+    pdm_mock::applet(GAME, PdmAppletEventType_InFocus, T0, T0, PdmPlayLogPolicy_None);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit, T0 + 100, T0 + 100, PdmPlayLogPolicy_None);
+
+    CHECK(fold().Seconds(GAME) == 0);
+}
+
+// two titles in focus one after the other, time goes to whichever has it.
+void test_switching_titles() {
+    pdm_mock::reset();
+    open_and_focus(USER, GAME, T0);
+    pdm_mock::applet(GAME, PdmAppletEventType_OutOfFocus, T0 + 100, T0 + 100);
+    open_and_focus(USER, GAME2, T0 + 110);
+    pdm_mock::applet(GAME2, PdmAppletEventType_Exit, T0 + 200, T0 + 200);
+    pdm_mock::applet(GAME, PdmAppletEventType_InFocus, T0 + 210, T0 + 210);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit, T0 + 250, T0 + 250);
+
+    const auto engine = fold();
+    CHECK(engine.Seconds(GAME) == 140);
+    CHECK(engine.Seconds(GAME2) == 90);
+}
+
+// 23:00 to 01:00 utc, seen from utc and from two hours ahead of it.
+void test_midnight_split() {
+    pdm_mock::reset();
+    const auto start = 19000 * DAY + 23 * 3600;
+    open_and_focus(USER, GAME, start);
+    pdm_mock::applet(GAME, PdmAppletEventType_Exit, start + 7200, start + 7200);
+
+    const auto utc = fold(USER, 0);
+    CHECK(utc.History().Range(GAME, 19000, 19000) == 3600);
+    CHECK(utc.History().Range(GAME, 19001, 19001) == 3600);
+
+    // 01:00 to 03:00 local, all of it on the next day
+    const auto ahead = fold(USER, 2 * 3600);
+    CHECK(ahead.History().Range(GAME, 19000, 19000) == 0);
+    CHECK(ahead.History().Range(GAME, 19001, 19001) == 7200);
+    CHECK(ahead.Seconds(GAME) == 7200);
+}
+
+// a long log with sessions left open across every batch boundary.
+void make_long_log() {
+    pdm_mock::reset();
+    auto t = T0;
+    for (int i = 0; i < 3000; i++) {
+        const auto id = GAME + static_cast<std::uint64_t>(i % 7) * 0x1000;
+        open_and_focus(i % 5 ? USER : OTHER, id, t);
+        pdm_mock::applet(id, PdmAppletEventType_OutOfFocus, t + 300, t + 300);
+        pdm_mock::applet(id, PdmAppletEventType_InFocus, t + 400, t + 400);
+        pdm_mock::applet(id, PdmAppletEventType_Exit, t + 1000 + i, t + 1000 + i);
+        t += 2 * 3600;
+    }
+}
+
+void test_incremental_fold() {
+    make_long_log();
+    const auto all = fold();
+    std::uint64_t expected{};
+    for (int i = 0; i < 3000; i++) {
+        expected += i % 5 ? 900 + i : 0;
+    }
+    std::uint64_t total{};
+    for (const auto& [id, seconds] : all.Totals()) {
+        total += seconds;
+    }
+    CHECK(total == expected);
+
+    // fold what's there, save, then carry on once more has been logged.
+    const auto events = pdm_mock::events;
+    pdm_mock::events.resize(events.size() / 3 + 1);
+
+    tj::PlaytimeEngine engine{USER, 0};
+    tj::PlayCursor cursor{};
+    CHECK(R_SUCCEEDED(tj::FoldPlayEvents(engine, cursor, std::stop_token{})));
+    CHECK(tj::IsCursorValid(cursor));
+
+    std::vector<std::uint8_t> saved;
+    engine.Serialize(saved);
+    pdm_mock::events = events;
+
+    tj::PlaytimeEngine loaded{USER, 0};
+    CHECK(loaded.Deserialize(saved));
+    CHECK(tj::IsCursorValid(cursor));
+    CHECK(R_SUCCEEDED(tj::FoldPlayEvents(loaded, cursor, std::stop_token{})));
+
+    CHECK(loaded.Totals() == all.Totals());
+    CHECK(loaded.EventCount() == all.EventCount());
+    for (const auto& [id, seconds] : all.Totals()) {
+        CHECK(loaded.History().Range(id, 0, UINT32_MAX) == seconds);
+    }
+
+    // a truncated save doesn't load
+    saved.resize(saved.size() / 2);
+    tj::PlaytimeEngine broken{USER, 0};
+    CHECK(!broken.Deserialize(saved));
+}
+
+void test_cursor_validity() {
+    make_long_log();
+    CHECK(tj::IsCursorValid({}));
+
+    tj::PlaytimeEngine engine{USER, 0};
+    tj::PlayCursor cursor{};
+    CHECK(R_SUCCEEDED(tj::FoldPlayEvents(engine, cursor, std::stop_token{})));
+    CHECK(tj::IsCursorValid(cursor));
+
+    // the last event read was replaced, eg the log was reset
+    auto& last = pdm_mock::events.back();
+    last.timestamp_steady++;
+    CHECK(!tj::IsCursorValid(cursor));
+    last.timestamp_steady--;
+
+    // old events rotated out, a fresh cursor would miss them
+    pdm_mock::rotate(10);
+    CHECK(tj::IsCursorValid(cursor));
+    CHECK(!tj::IsCursorValid({}));
+
+    // and once the last event read is gone too
+    pdm_mock::rotate(pdm_mock::events.size());
+    CHECK(!tj::IsCursorValid(cursor));
+}
+
+void test_stop() {
+    make_long_log();
+    std::stop_source source;
+    source.request_stop();
+    tj::PlaytimeEngine engine{USER, 0};
+    tj::PlayCursor cursor{};
+    tj::FoldPlayEvents(engine, cursor, source.get_token());
+    CHECK(cursor.next_index == 0);
+    CHECK(engine.EventCount() == 0);
+}
+
+} // namespace
+
+int main() {
+    test_focus_and_exit();
+    test_account_open_close();
+    test_other_users();
+    test_network_account_events();
+    test_suspend();
+    test_log_policy();
+    test_switching_titles();
+    test_midnight_split();
+    test_incremental_fold();
+    test_cursor_validity();
+    test_stop();
+    return test::result();
+}
@@ -0,0 +1,136 @@
+#include "play_history.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// years of synthetic history for a thousand titles: how long folding it in,
+// saving / loading the cache and answering range queries takes.
+namespace {
+
+constexpr std::uint64_t DAY{tj::PlayHistory::SECONDS_PER_DAY};
+constexpr std::uint64_t TITLES{1000};
+constexpr std::uint32_t FIRST_DAY{17230}; // 2017-03-03
+constexpr std::uint32_t YEARS{8};
+constexpr std::uint32_t DAYS{YEARS * 365};
+// the engine flushes once per batch of events read.
+constexpr int FLUSH_EVERY{1024 / 4};
+
+// a few titles get most of the play, every title gets some.
+auto title_id(std::mt19937_64& rng) -> std::uint64_t {
+    std::geometric_distribution<std::uint64_t> favourite{0.02};
+    std::uniform_int_distribution<std::uint64_t> any{0, TITLES - 1};
+    const auto index = rng() % 4 ? favourite(rng) % TITLES : any(rng);
+    return 0x0100000000010000 + index * 0x1000;
+}
+
+struct Session {
+    std::uint64_t id;
+    std::uint64_t clock;
+    std::uint64_t seconds;
+};
+
+auto make_sessions() -> std::vector<Session> {
+    std::mt19937_64 rng{36};
+    std::uniform_int_distribution<std::uint64_t> per_day{4, 24};
+    std::uniform_int_distribution<std::uint64_t> start{0, DAY - 1};
+    std::uniform_int_distribution<std::uint64_t> length{60, 4 * 3600};
+
+    std::vector<Session> sessions;
+    for (std::uint64_t day = FIRST_DAY; day < FIRST_DAY + DAYS; day++) {
+        const auto count = per_day(rng);
+        for (std::uint64_t i = 0; i < count; i++) {
+            sessions.push_back({title_id(rng), day * DAY + start(rng), length(rng)});
+        }
+    }
+    return sessions;
+}
+
+// what Range() would cost without the running totals.
+auto sum_rows(const tj::PlayHistory& history, std::uint64_t id, std::uint32_t first, std::uint32_t last) -> std::uint64_t {
+    const auto title = history.Find(id);
+    if (title < 0) {
+        return 0;
+    }
+    const auto days = history.Days(title);
+    const auto seconds = history.Seconds(title);
+    std::uint64_t sum{};
+    for (std::size_t i = 0; i < days.size(); i++) {
+        if (days[i] >= first && days[i] <= last) {
+            sum += seconds[i];
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+int main() {
+    const auto sessions = make_sessions();
+    tj::PlayHistory history;
+
+    const auto fold_ms = test::best_ms(1, [&]{
+        for (std::size_t i = 0; i < sessions.size(); i++) {
+            history.Add(sessions[i].id, sessions[i].clock, sessions[i].seconds);
+            if (i % FLUSH_EVERY == FLUSH_EVERY - 1) {
+                history.Flush();
+            }
+        }
+        history.Flush();
+    });
+    std::printf("%u years, %zu sessions, %zu titles, %zu rows\n", YEARS, sessions.size(), history.TitleCount(), history.RowCount());
+    std::printf("  add + flush    %8.2f ms\n", fold_ms);
+
+    std::vector<std::uint8_t> encoded;
+    const auto encode_ms = test::best_ms(5, [&]{
+        encoded.clear();
+        history.Encode(encoded);
+    });
+    tj::PlayHistory decoded;
+    const auto decode_ms = test::best_ms(5, [&]{
+        CHECK(decoded.Decode(encoded));
+    });
+    std::printf("  encode         %8.2f ms, %zu bytes (%.1f per row)\n", encode_ms, encoded.size(), static_cast<double>(encoded.size()) / history.RowCount());
+    std::printf("  decode         %8.2f ms\n", decode_ms);
+
+    // the titles asked about are played about as much as the ones in the
+    // history. last week / month / year / everything.
+    constexpr int QUERIES{100000};
+    std::mt19937_64 rng{1};
+    const std::uint32_t spans[]{7, 30, 365, DAYS};
+    std::vector<std::uint64_t> ids(QUERIES);
+    for (auto& id : ids) {
+        id = title_id(rng);
+    }
+
+    for (const auto span : spans) {
+        const auto last = FIRST_DAY + DAYS - 1;
+        const auto first = last - span + 1;
+        std::uint64_t fast{}, slow{}, total{};
+        const auto range_ms = test::best_ms(3, [&]{
+            fast = 0;
+            for (const auto id : ids) {
+                fast += decoded.Range(id, first, last);
+            }
+        });
+        const auto rows_ms = test::best_ms(3, [&]{
+            slow = 0;
+            for (const auto id : ids) {
+                slow += sum_rows(decoded, id, first, last);
+            }
+        });
+        const auto total_ms = test::best_ms(3, [&]{
+            for (int i = 0; i < QUERIES; i++) {
+                total += decoded.Total(first - i % 7, last);
+            }
+        });
+        test::keep(total);
+        CHECK(fast == slow);
+        std::printf("  last %4u days: Range %6.1f ns, summing rows %7.1f ns, Total %5.1f ns\n", span,
+            range_ms * 1e6 / QUERIES, rows_ms * 1e6 / QUERIES, total_ms * 1e6 / QUERIES);
+    }
+
+    return test::result();
+}
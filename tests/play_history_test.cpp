@@ -0,0 +1,191 @@
+#include "play_history.hpp"
+#include "byte_io.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// random Add() / Flush() rounds checked against summing up a plain
+// (title, day) -> seconds map, which is what the prefix sums stand in for.
+namespace {
+
+using Reference = std::map<std::pair<std::uint64_t, std::uint32_t>, std::uint64_t>;
+constexpr std::uint64_t DAY{tj::PlayHistory::SECONDS_PER_DAY};
+
+// splits the session at midnight the slow way, day by day.
+void reference_add(Reference& ref, std::uint64_t id, std::uint64_t clock, std::uint64_t seconds) {
+    const auto end = clock + seconds;
+    for (auto day = clock / DAY; day * DAY < end; day++) {
+        const auto from = std::max(clock, day * DAY);
+        const auto to = std::min(end, (day + 1) * DAY);
+        ref[{id, static_cast<std::uint32_t>(day)}] += to - from;
+    }
+}
+
+auto reference_range(const Reference& ref, std::uint64_t id, std::uint32_t first, std::uint32_t last) -> std::uint64_t {
+    std::uint64_t sum{};
+    for (const auto& [key, seconds] : ref) {
+        if (key.first == id && key.second >= first && key.second <= last) {
+            sum += seconds;
+        }
+    }
+    return sum;
+}
+
+auto reference_total(const Reference& ref, std::uint32_t first, std::uint32_t last) -> std::uint64_t {
+    std::uint64_t sum{};
+    for (const auto& [key, seconds] : ref) {
+        if (key.second >= first && key.second <= last) {
+            sum += seconds;
+        }
+    }
+    return sum;
+}
+
+void check_matches(const tj::PlayHistory& history, const Reference& ref, std::mt19937_64& rng, std::uint32_t base_day, std::uint32_t span) {
+    std::uniform_int_distribution<std::uint32_t> day{base_day - 5, base_day + span + 5};
+    std::uniform_int_distribution<std::uint64_t> id{1, 12};
+
+    for (int i = 0; i < 200; i++) {
+        auto first = day(rng);
+        auto last = day(rng);
+        if (i % 4) {
+            // mostly valid ranges, some empty ones
+            std::tie(first, last) = std::minmax(first, last);
+        }
+        const auto title = id(rng);
+        CHECK(history.Range(title, first, last) == reference_range(ref, title, first, last));
+        CHECK(history.Total(first, last) == reference_total(ref, first, last));
+    }
+
+    CHECK(history.Total(0, UINT32_MAX) == reference_total(ref, 0, UINT32_MAX));
+
+    // the rows themselves, title by title.
+    std::size_t rows{};
+    for (std::uint64_t title = 1; title <= 12; title++) {
+        const auto index = history.Find(title);
+        const auto begin = ref.lower_bound({title, 0});
+        const auto end = ref.lower_bound({title + 1, 0});
+        CHECK((index < 0) == (begin == end));
+        if (index < 0) {
+            continue;
+        }
+
+        const auto days = history.Days(index);
+        const auto seconds = history.Seconds(index);
+        std::size_t row{};
+        for (auto it = begin; it != end; ++it, row++) {
+            CHECK(row < days.size() && days[row] == it->first.second && seconds[row] == it->second);
+        }
+        CHECK(row == days.size());
+        rows += days.size();
+    }
+    CHECK(rows == history.RowCount());
+}
+
+void test_random_rounds() {
+    std::mt19937_64 rng{37};
+    constexpr std::uint32_t BASE_DAY{19000};
+    constexpr std::uint32_t SPAN{400};
+
+    tj::PlayHistory history;
+    Reference ref;
+    std::uniform_int_distribution<std::uint64_t> id{1, 10}; // 11 and 12 never played
+    std::uniform_int_distribution<std::uint64_t> clock{BASE_DAY * DAY, (BASE_DAY + SPAN) * DAY};
+    std::uniform_int_distribution<std::uint64_t> length{1, 3 * DAY};
+    std::uniform_int_distribution<int> adds{0, 40};
+
+    for (int round = 0; round < 60; round++) {
+        const auto count = adds(rng);
+        for (int i = 0; i < count; i++) {
+            const auto title = id(rng);
+            const auto start = clock(rng);
+            const auto seconds = length(rng);
+            history.Add(title, start, seconds);
+            reference_add(ref, title, start, seconds);
+        }
+
+        history.Flush();
+        check_matches(history, ref, rng, BASE_DAY, SPAN);
+    }
+
+    // what comes back from the cache has to answer the same.
+    std::vector<std::uint8_t> encoded;
+    history.Encode(encoded);
+    tj::PlayHistory decoded;
+    CHECK(decoded.Decode(encoded));
+    check_matches(decoded, ref, rng, BASE_DAY, SPAN);
+}
+
+void test_midnight_split() {
+    tj::PlayHistory history;
+    // an hour either side of midnight
+    history.Add(1, 10 * DAY - 3600, 7200);
+    CHECK(history.Range(1, 9, 9) == 0); // not flushed yet
+    history.Flush();
+    CHECK(history.Range(1, 9, 9) == 3600);
+    CHECK(history.Range(1, 10, 10) == 3600);
+    CHECK(history.Range(1, 9, 10) == 7200);
+    CHECK(history.Range(1, 10, 9) == 0);
+    CHECK(history.Range(2, 0, 100) == 0);
+    CHECK(history.Total(0, 8) == 0);
+    CHECK(history.Total(11, 100) == 0);
+    CHECK(history.Total(0, 100) == 7200);
+}
+
+// hand written cache data: titles, rows, id deltas, rows per title,
+// day deltas, seconds. everything's a varint.
+auto encode(std::initializer_list<std::uint64_t> values) -> std::vector<std::uint8_t> {
+    std::vector<std::uint8_t> out;
+    util::ByteWriter writer{out};
+    for (const auto value : values) {
+        writer.put_varint(value);
+    }
+    return out;
+}
+
+void test_decode_rejects_corruption() {
+    tj::PlayHistory history;
+    // two titles, two rows each
+    CHECK(history.Decode(encode({2, 4, 5, 2, 2, 2, 19000, 1, 19000, 3, 60, 60, 60, 60})));
+    CHECK(history.Range(7, 19000, 19003) == 120);
+    CHECK(history.Total(19000, 19003) == 240);
+
+    // the same title twice
+    CHECK(!history.Decode(encode({2, 2, 5, 0, 1, 1, 19000, 19000, 60, 60})));
+    // a title's days have to go up
+    CHECK(!history.Decode(encode({1, 2, 5, 2, 19000, 0, 60, 60})));
+    // past the last day a u32 can hold
+    CHECK(!history.Decode(encode({1, 2, 5, 2, UINT32_MAX, 1, 60, 60})));
+    CHECK(!history.Decode(encode({1, 1, 5, 1, std::uint64_t{UINT32_MAX} + 1, 60})));
+    // thousands of years between the first and last day played
+    CHECK(!history.Decode(encode({2, 2, 5, 1, 1, 1, 4'000'000, 60, 60})));
+    // more seconds than a row holds
+    CHECK(!history.Decode(encode({1, 1, 5, 1, 19000, std::uint64_t{UINT32_MAX} + 1})));
+    // rows that don't add up, and data cut short
+    CHECK(!history.Decode(encode({1, 2, 5, 1, 19000, 60, 60})));
+    CHECK(!history.Decode(encode({1, 2, 5, 2, 19000, 1, 60})));
+
+    // a rejected decode leaves what was there alone
+    CHECK(history.Range(7, 19000, 19003) == 120);
+    CHECK(history.Total(19000, 19003) == 240);
+
+    CHECK(history.Decode(encode({0, 0})));
+    CHECK(history.RowCount() == 0);
+    CHECK(history.Total(0, UINT32_MAX) == 0);
+}
+
+} // namespace
+
+int main() {
+    test_midnight_split();
+    test_random_rounds();
+    test_decode_rejects_corruption();
+    return test::result();
+}
@@ -0,0 +1,108 @@
+#include "playtime_stats.hpp"
+#include "title_table.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// PlaytimeStats::Compute() against the same figures read off a fully
+// sorted copy of the column.
+namespace {
+
+void check(const tj::TitleTable& table, const std::vector<tj::TitleTable::Row>& rows) {
+    const auto stats = tj::PlaytimeStats::Compute(table, rows);
+    const auto n = rows.size();
+    CHECK(stats.count == n);
+    if (!n) {
+        CHECK(stats.total == 0 && stats.median == 0 && stats.p90 == 0);
+        CHECK(stats.top.empty());
+        return;
+    }
+
+    std::vector<std::uint64_t> sorted;
+    std::uint64_t total{};
+    std::size_t played{};
+    std::array<std::uint32_t, tj::PlaytimeStats::BUCKET_HOURS.size()> histogram{};
+    for (const auto row : rows) {
+        const auto value = table.Seconds(row);
+        sorted.emplace_back(value);
+        total += value;
+        played += value != 0;
+        histogram[tj::PlaytimeStats::Bucket(value)]++;
+    }
+    std::ranges::sort(sorted);
+
+    CHECK(stats.total == total);
+    CHECK(stats.played == played);
+    CHECK(stats.mean == total / n);
+    CHECK(stats.histogram == histogram);
+
+    const auto median = n % 2 ? sorted[n / 2] : sorted[n / 2 - 1] + (sorted[n / 2] - sorted[n / 2 - 1]) / 2;
+    CHECK(stats.median == median);
+    // nearest rank, ceil(0.9 n)
+    CHECK(stats.p90 == sorted[(n * 9 + 9) / 10 - 1]);
+
+    auto top = rows;
+    std::ranges::stable_sort(top, [&](auto a, auto b) {
+        return table.Seconds(a) != table.Seconds(b) ? table.Seconds(a) > table.Seconds(b) : table.NameLess(a, b);
+    });
+    top.resize(std::min(tj::PlaytimeStats::TOP_COUNT, n));
+    CHECK(stats.top.size() == top.size());
+    for (std::size_t i = 0; i < top.size() && i < stats.top.size(); i++) {
+        // rows with the same seconds and name are interchangeable
+        CHECK(table.Seconds(stats.top[i]) == table.Seconds(top[i]));
+        CHECK(table.Name(stats.top[i]) == table.Name(top[i]));
+    }
+}
+
+void test_against_sorted() {
+    std::mt19937_64 rng{49};
+    std::uniform_int_distribution<std::uint64_t> seconds{0, 300 * 3600};
+    std::uniform_int_distribution<int> name{0, 49};
+
+    for (const std::size_t count : {0, 1, 2, 3, 4, 9, 10, 11, 20, 100, 1001, 20000}) {
+        tj::TitleTable table;
+        for (std::size_t i = 0; i < count; i++) {
+            tj::AppEntry entry{};
+            entry.name = "Game " + std::to_string(name(rng));
+            entry.id = i;
+            // a quarter never played, so there are plenty of ties
+            entry.playtime = Playtime::fromSeconds(rng() % 4 ? seconds(rng) : 0);
+            table.Add(std::move(entry));
+        }
+
+        std::vector<tj::TitleTable::Row> all, odd;
+        for (std::size_t i = 0; i < count; i++) {
+            all.emplace_back(static_cast<tj::TitleTable::Row>(i));
+            if (i % 2) {
+                odd.emplace_back(static_cast<tj::TitleTable::Row>(i));
+            }
+        }
+        check(table, all);
+        // only the rows asked for count
+        check(table, odd);
+    }
+}
+
+void test_buckets() {
+    CHECK(tj::PlaytimeStats::Bucket(0) == 0);
+    CHECK(tj::PlaytimeStats::Bucket(3599) == 0);
+    CHECK(tj::PlaytimeStats::Bucket(3600) == 1);
+    CHECK(tj::PlaytimeStats::Bucket(5 * 3600 - 1) == 1);
+    CHECK(tj::PlaytimeStats::Bucket(5 * 3600) == 2);
+    CHECK(tj::PlaytimeStats::Bucket(249 * 3600) == 6);
+    CHECK(tj::PlaytimeStats::Bucket(250 * 3600) == 7);
+    CHECK(tj::PlaytimeStats::Bucket(~std::uint64_t{}) == 7);
+}
+
+} // namespace
+
+int main() {
+    test_against_sorted();
+    test_buckets();
+    return test::result();
+}
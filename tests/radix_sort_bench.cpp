@@ -0,0 +1,68 @@
+#include "radix_sort.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// sorting rows by playtime, a u64 looked up per row, from 1k to 1M rows.
+// radix_sort against std::ranges::sort and std::ranges::stable_sort with
+// the same lookup in the comparison.
+namespace {
+
+template<typename Fn>
+double sort_ms(const std::vector<std::uint32_t>& input, std::vector<std::uint32_t>& rows, Fn&& fn) {
+    auto best = 1e300;
+    for (int i = 0; i < 5; i++) {
+        rows = input;
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double, std::milli> took{std::chrono::steady_clock::now() - start};
+        best = std::min(best, took.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937_64 rng{44};
+    std::printf("%9s %12s %12s %12s\n", "rows", "radix_sort", "sort", "stable_sort");
+
+    for (const std::size_t size : {1'000, 10'000, 100'000, 1'000'000}) {
+        // a third never played, the rest up to a few hundred hours
+        std::uniform_int_distribution<std::uint64_t> played{1, 500 * 3600};
+        std::vector<std::uint64_t> seconds(size);
+        for (std::size_t i = 0; i < size; i++) {
+            seconds[i] = i % 3 ? played(rng) : 0;
+        }
+
+        std::vector<std::uint32_t> input(size);
+        for (std::size_t i = 0; i < size; i++) {
+            input[i] = static_cast<std::uint32_t>(i);
+        }
+
+        std::vector<std::uint32_t> rows, radix, stable;
+        const auto by_seconds = [&](auto a, auto b) { return seconds[a] > seconds[b]; };
+
+        const auto radix_ms = sort_ms(input, rows, [&]{
+            util::radix_sort(std::span{rows}, [&](auto row) { return ~seconds[row]; });
+        });
+        radix = rows;
+        const auto sort_ms_ = sort_ms(input, rows, [&]{
+            std::ranges::sort(rows, by_seconds);
+        });
+        const auto stable_ms = sort_ms(input, rows, [&]{
+            std::ranges::stable_sort(rows, by_seconds);
+        });
+        stable = rows;
+
+        CHECK(radix == stable);
+        std::printf("%9zu %9.3f ms %9.3f ms %9.3f ms\n", size, radix_ms, sort_ms_, stable_ms);
+    }
+
+    return test::result();
+}
@@ -0,0 +1,109 @@
+#include "radix_sort.hpp"
+#include "title_table.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// radix_sort() has to agree with std::stable_sort, and the playtime order
+// built on it has to break ties by name.
+namespace {
+
+struct Item {
+    std::uint64_t key;
+    std::uint32_t index; // where it started, to see that ties kept their order
+    bool operator==(const Item&) const = default;
+};
+
+void check_stable(std::vector<Item> items) {
+    auto expected = items;
+    std::ranges::stable_sort(expected, {}, &Item::key);
+    util::radix_sort(std::span{items}, [](const Item& item) { return item.key; });
+    CHECK(items == expected);
+}
+
+void test_stable() {
+    std::mt19937_64 rng{44};
+    for (const std::size_t size : {0, 1, 2, 3, 100, 1000, 70000}) {
+        // keys from a small set, lots of ties
+        std::vector<Item> items(size);
+        std::uniform_int_distribution<std::uint64_t> few{0, 20};
+        for (std::uint32_t i = 0; i < size; i++) {
+            items[i] = {few(rng) * 3600, i};
+        }
+        check_stable(items);
+
+        // every byte of the key in play, including the top one
+        for (std::uint32_t i = 0; i < size; i++) {
+            items[i] = {rng() | (i % 2 ? 0x8000000000000000 : 0), i};
+        }
+        check_stable(items);
+
+        // only the middle bytes differ, the others are skipped
+        for (std::uint32_t i = 0; i < size; i++) {
+            items[i] = {0xAA000000000000BB | (few(rng) << 24), i};
+        }
+        check_stable(items);
+
+        // already sorted, and reversed
+        for (std::uint32_t i = 0; i < size; i++) {
+            items[i] = {i / 3, i};
+        }
+        check_stable(items);
+        std::ranges::reverse(items);
+        check_stable(items);
+    }
+}
+
+auto make_table(std::size_t count, std::mt19937_64& rng) -> tj::TitleTable {
+    static constexpr const char* NAMES[]{"zelda", "Zelda", "Mario", "mario kart", "Élite", "elite", "Tetris", "pikmin", "Pikmin 4"};
+    std::uniform_int_distribution<std::size_t> name{0, std::size(NAMES) - 1};
+    std::uniform_int_distribution<std::uint64_t> hours{0, 6};
+
+    tj::TitleTable table;
+    for (std::size_t i = 0; i < count; i++) {
+        tj::AppEntry entry{};
+        // names repeat apart from a suffix, so ties need the whole key
+        entry.name = std::string{NAMES[name(rng)]} + " " + std::to_string(count - i);
+        entry.author = "author";
+        entry.id = i;
+        // a few very common playtimes, eg never played
+        entry.playtime = Playtime::fromSeconds(i % 3 ? hours(rng) * 3600 : 0);
+        table.Add(std::move(entry));
+    }
+    return table;
+}
+
+void test_playtime_ties_by_name() {
+    std::mt19937_64 rng{440};
+    for (const std::size_t size : {0, 1, 50, 5000}) {
+        const auto table = make_table(size, rng);
+        for (const auto big_first : {true, false}) {
+            std::vector<tj::TitleTable::Row> rows(size);
+            for (std::size_t i = 0; i < size; i++) {
+                rows[i] = static_cast<tj::TitleTable::Row>(i);
+            }
+            auto expected = rows;
+
+            tj::SortByPlaytime(table, rows, big_first);
+            std::ranges::stable_sort(expected, [&](auto a, auto b) {
+                if (table.Seconds(a) != table.Seconds(b)) {
+                    return big_first ? table.Seconds(a) > table.Seconds(b) : table.Seconds(a) < table.Seconds(b);
+                }
+                return table.NameLess(a, b);
+            });
+            CHECK(rows == expected);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    test_stable();
+    test_playtime_ties_by_name();
+    return test::result();
+}
@@ -0,0 +1,101 @@
+#include "spsc_queue.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// one producer and one consumer hammering a small queue, so that it keeps
+// going full and empty. values count up from 0, so seeing exactly
+// 0, 1, 2, ... on the consumer side means everything arrived once, in order.
+// run under thread sanitizer, which checks the memory ordering.
+namespace {
+
+constexpr std::uint64_t COUNT{1 << 21};
+
+void test_fifo() {
+    util::SpscQueue<std::uint64_t, 64> queue;
+    std::uint64_t expected{};
+    std::uint64_t out_of_order{};
+
+    std::jthread producer{[&queue]{
+        for (std::uint64_t i = 0; i < COUNT; i++) {
+            auto value = i;
+            while (!queue.try_push(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    while (expected < COUNT) {
+        std::uint64_t value{};
+        if (!queue.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        out_of_order += value != expected;
+        expected++;
+    }
+
+    producer.join();
+    std::uint64_t extra{};
+    CHECK(out_of_order == 0);
+    CHECK(!queue.try_pop(extra));
+}
+
+// same again with values that own memory, popped in batches with drain(),
+// which is how the app uses it. a value moved twice or never freed shows up
+// as a null pointer here or a leak.
+void test_drain_owning() {
+    util::SpscQueue<std::unique_ptr<std::uint64_t>, 64> queue;
+    std::uint64_t expected{};
+    std::uint64_t bad{};
+
+    std::jthread producer{[&queue]{
+        for (std::uint64_t i = 0; i < COUNT; i++) {
+            auto value = std::make_unique<std::uint64_t>(i);
+            while (!queue.try_push(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    while (expected < COUNT) {
+        const auto drained = queue.drain([&](std::unique_ptr<std::uint64_t>&& value) {
+            bad += !value || *value != expected;
+            expected++;
+        });
+        if (!drained) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    CHECK(bad == 0);
+    CHECK(expected == COUNT);
+}
+
+void test_full_empty() {
+    util::SpscQueue<int, 4> queue;
+    int value{};
+    CHECK(!queue.try_pop(value));
+    for (int i = 0; i < 4; i++) {
+        auto v = i;
+        CHECK(queue.try_push(std::move(v)));
+    }
+    auto v = 4;
+    CHECK(!queue.try_push(std::move(v)));
+    CHECK(v == 4); // left alone when full
+    CHECK(queue.try_pop(value) && value == 0);
+    CHECK(queue.try_push(std::move(v)));
+    CHECK(queue.drain([](int&&){}) == 4);
+}
+
+} // namespace
+
+int main() {
+    test_full_empty();
+    test_fifo();
+    test_drain_owning();
+    return test::result();
+}
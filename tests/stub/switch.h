@@ -0,0 +1,151 @@
+#pragma once
+
+// just enough of libnx for the app sources the host tests build.
+// layouts follow libnx, the functions are defined by whichever test needs them.
+
+#include <cstddef>
+#include <cstdint>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+typedef u32 Result;
+
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_FAILED(res) ((res) != 0)
+
+typedef struct {
+    u64 uid[2];
+} AccountUid;
+
+// pdm
+typedef enum {
+    PdmPlayEventType_Applet = 0,
+    PdmPlayEventType_Account = 1,
+    PdmPlayEventType_PowerStateChange = 2,
+    PdmPlayEventType_OperationModeChange = 3,
+    PdmPlayEventType_Initialize = 4,
+} PdmPlayEventType;
+
+typedef enum {
+    PdmAppletEventType_Launch = 0,
+    PdmAppletEventType_Exit = 1,
+    PdmAppletEventType_InFocus = 2,
+    PdmAppletEventType_OutOfFocus = 3,
+    PdmAppletEventType_OutOfFocus4 = 4,
+    PdmAppletEventType_Exit5 = 5,
+    PdmAppletEventType_Exit6 = 6,
+} PdmAppletEventType;
+
+typedef enum {
+    PdmPlayLogPolicy_All = 0,
+    PdmPlayLogPolicy_LogOnly = 1,
+    PdmPlayLogPolicy_None = 2,
+} PdmPlayLogPolicy;
+
+typedef struct {
+    u32 program_id[2];
+    union {
+        struct {
+            u32 version;
+            u8 unk_x4[0x8];
+        } application_info;
+        u8 data[0xC];
+    } unk_x8;
+    u8 applet_id;
+    u8 storage_id;
+    u8 log_policy;
+    u8 event_type;
+    u8 unk_x18[0x4];
+} PdmPlayEventAppletData;
+
+typedef struct {
+    u32 uid[4];
+    union {
+        struct {
+            u32 application_id[2];
+        } application_info;
+        u8 data[0x8];
+    } unk_x10;
+    u8 type;
+    u8 unk_x19[0x3];
+} PdmPlayEventAccountData;
+
+typedef struct {
+    u8 value;
+    u8 unk_x1[0x1B];
+} PdmPlayEventPowerStateChangeData;
+
+typedef struct {
+    u8 value;
+    u8 unk_x1[0x1B];
+} PdmPlayEventOperationModeChangeData;
+
+typedef struct {
+    union {
+        PdmPlayEventAppletData applet;
+        PdmPlayEventAccountData account;
+        PdmPlayEventPowerStateChangeData powerStateChange;
+        PdmPlayEventOperationModeChangeData operationModeChange;
+        u8 data[0x1C];
+    } event_data;
+    u8 play_event_type;
+    u8 pad[0x3];
+    u64 timestamp_user;
+    u64 timestamp_network;
+    u64 timestamp_steady;
+} PdmPlayEvent;
+
+typedef struct {
+    u64 application_id;
+    u32 first_entry_index;
+    u64 first_timestamp_user;
+    u64 first_timestamp_network;
+    u32 last_entry_index;
+    u64 last_timestamp_user;
+    u64 last_timestamp_network;
+    u64 playtime;
+    u32 total_launches;
+} PdmPlayStatistics;
+
+Result pdmqryQueryPlayEvent(s32 entry_index, PdmPlayEvent* events, s32 count, s32* total_out);
+Result pdmqryGetAvailablePlayEventRange(s32* total_entries, s32* start_entry_index, s32* end_entry_index);
+Result pdmqryQueryPlayStatisticsByApplicationIdAndUserAccountId(u64 application_id, AccountUid uid, bool flag, PdmPlayStatistics* stats);
+
+// time
+typedef enum {
+    TimeType_UserSystemClock,
+    TimeType_NetworkSystemClock,
+    TimeType_LocalSystemClock,
+    TimeType_Default = TimeType_UserSystemClock,
+} TimeType;
+
+typedef struct {
+    u16 year;
+    u8 month;
+    u8 day;
+    u8 hour;
+    u8 minute;
+    u8 second;
+    u8 pad;
+} TimeCalendarTime;
+
+typedef struct {
+    char name[0x24];
+} TimeLocationName;
+
+typedef struct {
+    u32 wday;
+    u32 yday;
+    char timezoneName[8];
+    u32 DST;
+    s32 offset;
+} TimeCalendarAdditionalInfo;
+
+Result timeGetCurrentTime(TimeType type, u64* timestamp);
+Result timeToCalendarTimeWithMyRule(u64 timestamp, TimeCalendarTime* caltime, TimeCalendarAdditionalInfo* info);
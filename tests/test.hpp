@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+// minimal harness for the host tests and benchmarks.
+// there are no exceptions to throw, a failed check is reported and counted
+// and main() returns test::result().
+namespace test {
+
+inline int failures{};
+
+inline int result() {
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// best of runs, in milliseconds. the best run is the one least disturbed
+// by everything else the machine is doing.
+template<typename Fn>
+double best_ms(int runs, Fn&& fn) {
+    auto best = std::numeric_limits<double>::max();
+    for (int i = 0; i < runs; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double, std::milli> took{std::chrono::steady_clock::now() - start};
+        best = took.count() < best ? took.count() : best;
+    }
+    return best;
+}
+
+// keeps the optimiser from dropping work whose result is never used.
+template<typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace test
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        test::failures++; \
+    } \
+} while (0)
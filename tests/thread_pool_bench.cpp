@@ -0,0 +1,94 @@
+#include "async.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <thread>
+#include <vector>
+
+// util::async used to be std::async, a fresh thread per call. this times
+// both for one job at a time (latency) and many small jobs at once
+// (throughput), on a pool of every core and one of three like the switch.
+namespace {
+
+constexpr int ROUND_TRIPS{20000};
+constexpr int JOBS{20000};
+
+// a little work so that the jobs aren't entirely overhead.
+auto work(std::uint64_t seed) -> std::uint64_t {
+    auto x = seed;
+    for (int i = 0; i < 256; i++) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return x;
+}
+
+void report(const char* name, double round_trip_ms, double jobs_ms) {
+    std::printf("  %-16s latency %6.2f us, throughput %8.0f jobs/s\n", name,
+        round_trip_ms * 1e3 / ROUND_TRIPS, JOBS / (jobs_ms / 1e3));
+}
+
+void bench_pool(const char* name, util::ThreadPool& pool) {
+    const auto round_trip_ms = test::best_ms(3, [&]{
+        for (int i = 0; i < ROUND_TRIPS; i++) {
+            auto future = pool.submit(util::Priority::Normal, work, i);
+            test::keep(future.get());
+        }
+    });
+
+    const auto jobs_ms = test::best_ms(3, [&]{
+        std::vector<util::AsyncFuture<std::uint64_t>> futures;
+        futures.reserve(JOBS);
+        for (int i = 0; i < JOBS; i++) {
+            futures.emplace_back(pool.submit(util::Priority::Normal, work, i));
+        }
+        std::uint64_t sum{};
+        for (auto& future : futures) {
+            sum += future.get();
+        }
+        test::keep(sum);
+    });
+
+    report(name, round_trip_ms, jobs_ms);
+}
+
+void bench_std_async() {
+    const auto round_trip_ms = test::best_ms(3, [&]{
+        for (int i = 0; i < ROUND_TRIPS; i++) {
+            auto future = std::async(std::launch::async, work, i);
+            test::keep(future.get());
+        }
+    });
+
+    const auto jobs_ms = test::best_ms(3, [&]{
+        std::vector<std::future<std::uint64_t>> futures;
+        futures.reserve(JOBS);
+        for (int i = 0; i < JOBS; i++) {
+            futures.emplace_back(std::async(std::launch::async, work, i));
+        }
+        std::uint64_t sum{};
+        for (auto& future : futures) {
+            sum += future.get();
+        }
+        test::keep(sum);
+    });
+
+    report("std::async", round_trip_ms, jobs_ms);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%d round trips, %d jobs of ~256 multiply-adds, %u cores\n", ROUND_TRIPS, JOBS, std::thread::hardware_concurrency());
+    bench_std_async();
+    {
+        util::ThreadPool pool{3};
+        bench_pool("pool, 3 workers", pool);
+    }
+    bench_pool("pool, every core", util::ThreadPool::get_default());
+
+    // make sure both give the same answers
+    CHECK(util::async(work, 7).get() == std::async(std::launch::async, work, 7).get());
+    return test::result();
+}
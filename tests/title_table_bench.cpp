@@ -0,0 +1,139 @@
+#include "title_table.hpp"
+#include "alloc_counter.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// the list used to be a vector<AppEntry> sorted in place, whole entries
+// moved around. the table sorts a permutation of rows over its columns.
+// both single threaded here, so only the layout is compared.
+namespace {
+
+auto make_entries(std::size_t count) -> std::vector<tj::AppEntry> {
+    std::mt19937_64 rng{41};
+    static constexpr const char* WORDS[]{
+        "super", "mario", "zelda", "legend", "of", "the", "wild", "breath", "kart", "party",
+        "xenoblade", "chronicles", "pokemon", "crossing", "animal", "smash", "bros", "splatoon",
+        "metroid", "dread", "fire", "emblem", "three", "houses", "kirby", "forgotten", "land",
+    };
+    std::uniform_int_distribution<std::size_t> word{0, std::size(WORDS) - 1};
+    std::uniform_int_distribution<int> words{2, 6};
+    std::uniform_int_distribution<int> author{0, 199};
+    std::uniform_int_distribution<std::uint64_t> seconds{0, 500 * 3600};
+
+    std::vector<tj::AppEntry> entries(count);
+    for (std::size_t i = 0; i < count; i++) {
+        auto& e = entries[i];
+        const auto n = words(rng);
+        for (int w = 0; w < n; w++) {
+            e.name += w ? " " : "";
+            e.name += WORDS[word(rng)];
+        }
+        e.name += " " + std::to_string(i);
+        e.author = "Publisher " + std::to_string(author(rng));
+        e.display_version = "1.0." + std::to_string(i % 20);
+        // a fifth never played, which makes for big runs of equal keys
+        e.playtime = Playtime::fromSeconds(i % 5 ? seconds(rng) : 0);
+        e.id = 0x0100000000010000 + i * 0x1000;
+        e.image = static_cast<int>(i);
+        e.installed = i % 10 != 0;
+    }
+    return entries;
+}
+
+// best of runs, setup isn't timed.
+template<typename Setup, typename Fn>
+double timed_ms(int runs, Setup&& setup, Fn&& fn) {
+    auto best = 1e300;
+    for (int i = 0; i < runs; i++) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double, std::milli> took{std::chrono::steady_clock::now() - start};
+        best = std::min(best, took.count());
+    }
+    return best;
+}
+
+void bench(std::size_t count) {
+    const auto source = make_entries(count);
+
+    // memory
+    auto before = alloc_counter::live.load();
+    auto entries = source;
+    const auto entries_bytes = alloc_counter::live.load() - before;
+
+    before = alloc_counter::live.load();
+    auto table = std::make_unique<tj::TitleTable>();
+    for (auto e : source) {
+        table->Add(std::move(e));
+    }
+    const auto table_bytes = alloc_counter::live.load() - before;
+
+    std::vector<tj::TitleTable::Row> rows(count);
+    const auto reset_rows = [&]{
+        for (std::size_t i = 0; i < count; i++) {
+            rows[i] = static_cast<tj::TitleTable::Row>(i);
+        }
+    };
+    const auto reset_entries = [&]{ entries = source; };
+
+    const auto vec_name = timed_ms(3, reset_entries, [&]{
+        std::ranges::sort(entries, [](const tj::AppEntry& a, const tj::AppEntry& b) { return a.name < b.name; });
+    });
+    const auto table_name = timed_ms(3, reset_rows, [&]{
+        std::ranges::sort(rows, [&](auto a, auto b) { return table->NameLess(a, b); });
+    });
+
+    const auto vec_playtime = timed_ms(3, reset_entries, [&]{
+        std::ranges::sort(entries, [](tj::AppEntry& a, tj::AppEntry& b) { return a.playtime.totalSeconds() > b.playtime.totalSeconds(); });
+    });
+    const auto table_playtime = timed_ms(3, reset_rows, [&]{
+        const auto seconds = table->SecondsColumn();
+        std::ranges::sort(rows, [seconds](auto a, auto b) { return seconds[a] > seconds[b]; });
+    });
+    CHECK(entries.front().playtime.totalSeconds() == table->Seconds(rows.front()));
+
+    std::size_t vec_shown{}, table_shown{};
+    const auto vec_filter = timed_ms(10, []{}, [&]{
+        std::vector<const tj::AppEntry*> shown;
+        for (const auto& e : entries) {
+            if (e.installed) {
+                shown.push_back(&e);
+            }
+        }
+        vec_shown = shown.size();
+    });
+    const auto table_filter = timed_ms(10, []{}, [&]{
+        const auto flags = table->FlagsColumn();
+        std::vector<tj::TitleTable::Row> shown;
+        for (tj::TitleTable::Row row = 0; row < flags.size(); row++) {
+            if (flags[row] & tj::TitleTable::Flag_Installed) {
+                shown.push_back(row);
+            }
+        }
+        table_shown = shown.size();
+    });
+    CHECK(vec_shown == table_shown);
+
+    std::printf("%zu titles\n", count);
+    std::printf("  memory           vector<AppEntry> %8.2f MiB, TitleTable %8.2f MiB\n", entries_bytes / 1048576.0, table_bytes / 1048576.0);
+    std::printf("  sort by name     vector<AppEntry> %8.2f ms,  TitleTable %8.2f ms\n", vec_name, table_name);
+    std::printf("  sort by playtime vector<AppEntry> %8.2f ms,  TitleTable %8.2f ms\n", vec_playtime, table_playtime);
+    std::printf("  filter installed vector<AppEntry> %8.2f ms,  TitleTable %8.2f ms\n", vec_filter, table_filter);
+}
+
+} // namespace
+
+int main() {
+    bench(10'000);
+    bench(100'000);
+    return test::result();
+}
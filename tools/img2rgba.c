@@ -0,0 +1,44 @@
+// converts an image into the raw blob linked into the app, see gfx::createImageRaw().
+// layout: u32 width, u32 height (little endian) followed by width * height rgba8 pixels.
+// built and ran on the host by the Makefile.
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_JPEG
+#include "stb_image.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+static void write_u32(FILE* f, uint32_t v) {
+    const unsigned char b[4] = { v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, (v >> 24) & 0xFF };
+    fwrite(b, 1, sizeof(b), f);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <in.jpg> <out.bin>\n", argv[0]);
+        return 1;
+    }
+
+    int w, h, n;
+    unsigned char* data = stbi_load(argv[1], &w, &h, &n, 4);
+    if (!data) {
+        fprintf(stderr, "failed to decode %s: %s\n", argv[1], stbi_failure_reason());
+        return 1;
+    }
+
+    FILE* f = fopen(argv[2], "wb");
+    if (!f) {
+        fprintf(stderr, "failed to open %s\n", argv[2]);
+        stbi_image_free(data);
+        return 1;
+    }
+
+    write_u32(f, (uint32_t)w);
+    write_u32(f, (uint32_t)h);
+    const size_t size = (size_t)w * (size_t)h * 4;
+    const int ok = fwrite(data, 1, size, f) == size;
+
+    fclose(f);
+    stbi_image_free(data);
+    return ok ? 0 : 1;
+}